@@ -0,0 +1,518 @@
+#include <SDL3/SDL.h>
+#include <SDL3/SDL_main.h>
+#include <cglm/cglm.h>
+#include <glad/glad.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "arena/arena.h"
+#include "blocks/blocks.h"
+#include "camera/camera.h"
+#include "glstats/glstats.h"
+#include "headless/headless.h"
+#include "ifs/ifs.h"
+#include "leaves/leaves.h"
+#include "memory/memory.h"
+#include "recursive/recursive.h"
+#include "shaders/shader.h"
+#include "splat/splat.h"
+
+/**
+ * Micro-benchmarks of leaf generation, the camera, shader loading and every
+ * render mode's submission, written as JSON (see README.md).
+ *
+ * Every metric is timed BENCH_SAMPLES times and the median reported. A sample
+ * repeats the work until it took at least BENCH_SAMPLE_NS, so short
+ * operations aren't lost in the clock's resolution. Everything is lower is
+ * better.
+ */
+
+// Where the results are written unless a path is given
+#define BENCH_JSON "bench.json"
+
+#define BENCH_SAMPLES 5
+#define BENCH_SAMPLE_NS 20000000ULL
+#define BENCH_MAX_REPETITIONS 100000
+
+// Size of the offscreen framebuffer, the app's window size
+#define BENCH_WIDTH 800
+#define BENCH_HEIGHT 800
+
+// Deepest pyramid generated, 5^9 leaves (~30 MiB)
+#define BENCH_MAX_GENERATE_DEPTH 9
+
+// Leaves generated for the other fractals, roughly
+#define BENCH_IFS_LEAVES (1 << 20)
+
+// Camera calls per repetition, they take nanoseconds each
+#define BENCH_CAMERA_CALLS 1000
+
+// Points splatted per re-accumulation, less than the app for a quick run
+#define BENCH_SPLAT_POINTS 2000000ULL
+
+typedef void (*BenchWork)(void *data);
+
+static FILE *out;
+static int results;
+
+// Keeps the compiler from dropping the camera work
+static volatile float sink;
+
+static int compare_doubles(const void *a, const void *b) {
+	double x = *(const double *)a;
+	double y = *(const double *)b;
+	return (x > y) - (x < y);
+}
+
+/**
+ * Median time of one call to `work`, in nanoseconds. With `gpu` set, GL is
+ * finished before the clock is read, so the GPU's work is included.
+ */
+static double measure(BenchWork work, void *data, bool gpu) {
+	// Warm up once, and estimate the repetitions a sample needs
+	Uint64 start = SDL_GetTicksNS();
+	work(data);
+	if (gpu) {
+		glFinish();
+	}
+	Uint64 once = SDL_GetTicksNS() - start;
+	Uint64 repetitions = BENCH_SAMPLE_NS / (once > 0 ? once : 1);
+	if (repetitions < 1) {
+		repetitions = 1;
+	} else if (repetitions > BENCH_MAX_REPETITIONS) {
+		repetitions = BENCH_MAX_REPETITIONS;
+	}
+
+	double samples[BENCH_SAMPLES];
+	for (int s = 0; s < BENCH_SAMPLES; s++) {
+		start = SDL_GetTicksNS();
+		for (Uint64 r = 0; r < repetitions; r++) {
+			work(data);
+		}
+		if (gpu) {
+			glFinish();
+		}
+		samples[s] = (double)(SDL_GetTicksNS() - start) / (double)repetitions;
+	}
+
+	qsort(samples, BENCH_SAMPLES, sizeof(double), compare_doubles);
+	return samples[BENCH_SAMPLES / 2];
+}
+
+// Write `text` as a JSON string, or null.
+static void write_string(const char *text) {
+	if (text == NULL) {
+		fprintf(out, "null");
+		return;
+	}
+	fputc('"', out);
+	for (const char *c = text; *c != '\0'; c++) {
+		if (*c == '"' || *c == '\\') {
+			fprintf(out, "\\%c", *c);
+		} else if ((unsigned char)*c < 0x20) {
+			fprintf(out, "\\u%04x", (unsigned char)*c);
+		} else {
+			fputc(*c, out);
+		}
+	}
+	fputc('"', out);
+}
+
+/**
+ * Write one result on its own line, with the extra fields in `extra_format`
+ * (printf style, starting with ", ") if not NULL, and print it.
+ */
+static void emit(const char *name, const char *unit, double value,
+                 const char *extra_format, ...) {
+	fprintf(out, "%s\n    {\"name\": ", results > 0 ? "," : "");
+	write_string(name);
+	fprintf(out, ", \"unit\": ");
+	write_string(unit);
+	fprintf(out, ", \"value\": %.6g", value);
+	if (extra_format != NULL) {
+		va_list args;
+		va_start(args, extra_format);
+		vfprintf(out, extra_format, args);
+		va_end(args);
+	}
+	fprintf(out, "}");
+	results++;
+
+	printf("%-44s %14.4f %s\n", name, value, unit);
+}
+
+// Model name of the first CPU, from /proc/cpuinfo where there is one.
+static void cpu_model(char *model, size_t size) {
+	snprintf(model, size, "unknown");
+	FILE *file = fopen("/proc/cpuinfo", "r");
+	if (file == NULL) {
+		return;
+	}
+	char line[256];
+	while (fgets(line, sizeof(line), file) != NULL) {
+		char *colon = strchr(line, ':');
+		if (strncmp(line, "model name", 10) == 0 && colon != NULL) {
+			snprintf(model, size, "%s", colon + 2);
+			model[strcspn(model, "\n")] = '\0';
+			break;
+		}
+	}
+	fclose(file);
+}
+
+static void write_machine(const Headless *headless) {
+	char model[128];
+	cpu_model(model, sizeof(model));
+
+	fprintf(out, "  \"machine\": {\n    \"platform\": ");
+	write_string(SDL_GetPlatform());
+	fprintf(out, ",\n    \"cpu\": ");
+	write_string(model);
+	fprintf(out, ",\n    \"logical_cores\": %d", SDL_GetNumLogicalCPUCores());
+	fprintf(out, ",\n    \"ram_mb\": %d", SDL_GetSystemRAM());
+	fprintf(out, ",\n    \"compiler\": ");
+#ifdef __VERSION__
+	write_string(__VERSION__);
+#else
+	write_string(NULL);
+#endif
+#ifdef NDEBUG
+	fprintf(out, ",\n    \"build\": \"release\"");
+#else
+	fprintf(out, ",\n    \"build\": \"debug\"");
+#endif
+#ifdef ENABLE_STAGE_TIMING
+	fprintf(out, ",\n    \"stage_timing\": true");
+#else
+	fprintf(out, ",\n    \"stage_timing\": false");
+#endif
+	const char *strings[3][2] = {{"gl_vendor", NULL},
+	                             {"gl_renderer", NULL},
+	                             {"gl_version", NULL}};
+	if (headless != NULL) {
+		strings[0][1] = (const char *)glGetString(GL_VENDOR);
+		strings[1][1] = (const char *)glGetString(GL_RENDERER);
+		strings[2][1] = (const char *)glGetString(GL_VERSION);
+	}
+	for (int i = 0; i < 3; i++) {
+		fprintf(out, ",\n    \"%s\": ", strings[i][0]);
+		write_string(strings[i][1]);
+	}
+	fprintf(out, "\n  },\n");
+}
+
+typedef struct GenerateWork {
+	const IFS *ifs;
+	int depth;
+	bool baked;
+} GenerateWork;
+
+static void generate(void *data) {
+	GenerateWork *work = (GenerateWork *)data;
+	LeafBuffer *buffer = CreateIFSLeafBuffer(work->ifs, work->depth);
+	if (buffer != NULL) {
+		work->baked = buffer->baked;
+		DestroyLeafBuffer(buffer);
+	}
+}
+
+static void emit_generate(const IFS *ifs, int depth) {
+	GenerateWork work = {ifs, depth, false};
+	Uint64 leaves = IFSLeafCount(ifs, depth);
+	double ns_per_leaf = measure(generate, &work, false) / (double)leaves;
+
+	char name[96];
+	snprintf(name, sizeof(name), "generate/%s/depth %d", ifs->name, depth);
+	emit(name, "ns/leaf", ns_per_leaf,
+	     ", \"leaves\": %llu, \"leaves_per_second\": %.6g, \"baked\": %s",
+	     (unsigned long long)leaves, 1e9 / ns_per_leaf,
+	     work.baked ? "true" : "false");
+}
+
+// Leaf generation of the pyramid at every depth, and of the other fractals
+// at the depth closest to BENCH_IFS_LEAVES.
+static void bench_generate(void) {
+	for (int depth = 0; depth <= BENCH_MAX_GENERATE_DEPTH; depth++) {
+		emit_generate(&ifs_sierpinski_pyramid, depth);
+	}
+	for (int f = 0; f < IFS_COUNT; f++) {
+		const IFS *ifs = ifs_list[f];
+		if (ifs == &ifs_sierpinski_pyramid) {
+			continue;
+		}
+		int depth = 0;
+		while (IFSLeafCount(ifs, depth + 1) <= BENCH_IFS_LEAVES) {
+			depth++;
+		}
+		emit_generate(ifs, depth);
+	}
+}
+
+static void rotate_camera(void *data) {
+	Camera *camera = (Camera *)data;
+	// Back and forth, so the pitch never reaches its limit
+	for (int i = 0; i < BENCH_CAMERA_CALLS; i++) {
+		RotateCamera(camera, (i & 1) ? -0.5f : 0.5f, 0.5f);
+	}
+	sink = camera->front[0];
+}
+
+static void move_camera(void *data) {
+	Camera *camera = (Camera *)data;
+	vec3 forward = {0.0f, 0.0f, -0.001f};
+	vec3 back = {0.0f, 0.0f, 0.001f};
+	for (int i = 0; i < BENCH_CAMERA_CALLS; i++) {
+		MoveCamera(camera, (i & 1) ? back : forward);
+	}
+	sink = camera->pos[2];
+}
+
+static void view_matrix(void *data) {
+	Camera *camera = (Camera *)data;
+	mat4 view;
+	for (int i = 0; i < BENCH_CAMERA_CALLS; i++) {
+		GetCameraViewMatrix(camera, view);
+		sink = view[3][2];
+	}
+}
+
+static void bench_camera(void) {
+	Camera *camera = CreateCamera((vec3){0.0, 0.0, 3.0}, (vec3){0.0, 0.0, 0.0},
+	                              (vec3){0.0, 1.0, 0.0});
+	emit("camera/RotateCamera", "ns/call",
+	     measure(rotate_camera, camera, false) / BENCH_CAMERA_CALLS, NULL);
+	emit("camera/MoveCamera", "ns/call",
+	     measure(move_camera, camera, false) / BENCH_CAMERA_CALLS, NULL);
+	emit("camera/GetCameraViewMatrix", "ns/call",
+	     measure(view_matrix, camera, false) / BENCH_CAMERA_CALLS, NULL);
+	DestroyCamera(camera);
+}
+
+static void load_program(void *data) {
+	const char **files = (const char **)data;
+	ShaderProgram *program = LoadShaderProgram(files[0], files[1]);
+	if (program != NULL) {
+		DeleteShaderProgram(program);
+	}
+}
+
+// Compiling and linking every program the app uses.
+static void bench_shaders(void) {
+	static const char *programs[][2] = {
+	    {"shader.vert", "shader.frag"},   {"instance.vert", "shader.frag"},
+	    {"pull.vert", "shader.frag"},     {"splat.vert", "splat.frag"},
+	    {"splat.vert", "overdraw.frag"}, {"hud.vert", "hud.frag"},
+	};
+	int count = (int)(sizeof(programs) / sizeof(programs[0]));
+	for (int i = 0; i < count; i++) {
+		char name[96];
+		snprintf(name, sizeof(name), "shader/%s+%s", programs[i][0],
+		         programs[i][1]);
+		emit(name, "ms", measure(load_program, programs[i], true) / 1e6,
+		     NULL);
+	}
+}
+
+// What a submission benchmark draws, from the app's starting camera
+typedef struct SubmitWork {
+	mat4 view;
+	mat4 perspective;
+	mat4 view_proj;
+	float eye[3];
+	int depth;
+	bool front_to_back;
+
+	RecursiveRenderer *recursive;
+	BlockRenderer *blocks;
+	Arena *frame_arena;
+	Splatter *splatter;
+	int frame;
+} SubmitWork;
+
+static void submit_recursive(void *data) {
+	SubmitWork *work = (SubmitWork *)data;
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	DrawRecursive(work->recursive, work->depth, work->view, work->perspective,
+	              work->front_to_back ? work->eye : NULL);
+	EndGLStatsFrame();
+}
+
+static void submit_blocks(void *data) {
+	SubmitWork *work = (SubmitWork *)data;
+	ResetArena(work->frame_arena);
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	DrawBlocks(work->blocks, work->view, work->perspective);
+	EndGLStatsFrame();
+}
+
+static void submit_splat(void *data) {
+	SubmitWork *work = (SubmitWork *)data;
+	// Nudge the view every frame so the points are splatted again
+	mat4 view_proj;
+	glm_mat4_copy(work->view_proj, view_proj);
+	view_proj[3][0] += (work->frame++ & 1) ? 1e-4f : -1e-4f;
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	UpdateSplatter(work->splatter, view_proj);
+	DrawSplatter(work->splatter);
+	EndGLStatsFrame();
+}
+
+// Milliseconds per frame of `submit`, with its name in `name`.
+static double time_submit(char name[96], const char *mode, int depth,
+                          BenchWork submit, SubmitWork *work) {
+	snprintf(name, 96, "submit/%s/depth %d", mode, depth);
+	return measure(submit, work, true) / 1e6;
+}
+
+// Every render mode and its options, frames drawn and finished.
+static void bench_submit(void) {
+	SubmitWork work;
+	memset(&work, 0, sizeof(work));
+	Camera *camera = CreateCamera((vec3){0.0, 0.0, 3.0}, (vec3){0.0, 0.0, 0.0},
+	                              (vec3){0.0, 1.0, 0.0});
+	GetCameraViewMatrix(camera, work.view);
+	glm_perspective(glm_rad(45.0f), (float)BENCH_WIDTH / BENCH_HEIGHT, 0.1f,
+	                100.0f, work.perspective);
+	glm_mat4_mul(work.perspective, work.view, work.view_proj);
+	glm_vec3_copy(camera->pos, work.eye);
+	DestroyCamera(camera);
+
+	work.recursive = CreateRecursiveRenderer();
+	if (work.recursive != NULL) {
+		static const int depths[] = {3, 5};
+		for (int i = 0; i < 4; i++) {
+			work.depth = depths[i / 2];
+			work.front_to_back = i & 1;
+			char name[96];
+			double ms = time_submit(
+			    name, work.front_to_back ? "recursive front-to-back"
+			                             : "recursive",
+			    work.depth, submit_recursive, &work);
+			emit(name, "ms/frame", ms, ", \"draw_calls\": %llu",
+			     (unsigned long long)LeafCount(work.depth));
+		}
+		DestroyRecursiveRenderer(work.recursive);
+	}
+
+	work.frame_arena = CreateArena("frame", FRAME_ARENA_SIZE);
+	if (work.frame_arena != NULL) {
+		work.blocks = CreateBlockRenderer(work.frame_arena);
+	}
+	if (work.blocks != NULL) {
+		static const char *variants[] = {"instanced", "instanced culled",
+		                                 "instanced culled front-to-back",
+		                                 "instanced pulled"};
+		static const int depths[] = {5, 7};
+		for (int i = 0; i < 2; i++) {
+			SetBlockRendererDepth(work.blocks, depths[i], 4);
+			for (int v = 0; v < 4; v++) {
+				work.blocks->cull = v == 1 || v == 2;
+				work.blocks->front_to_back = v == 2;
+				work.blocks->pull = v == 3;
+				char name[96];
+				// Without pulling DrawBlocks would time the mesh path
+				if (work.blocks->pull &&
+				    !BlockRendererCanPull(work.blocks)) {
+					printf("submit/%s/depth %d skipped, vertex pulling isn't "
+					       "available\n",
+					       variants[v], depths[i]);
+					continue;
+				}
+				double ms = time_submit(name, variants[v], depths[i],
+				                        submit_blocks, &work);
+				emit(name, "ms/frame", ms,
+				     ", \"draw_calls\": %u, \"instances_drawn\": %llu",
+				     work.blocks->draw_calls,
+				     (unsigned long long)work.blocks->instances_drawn);
+			}
+		}
+		DestroyBlockRenderer(work.blocks);
+	}
+	if (work.frame_arena != NULL) {
+		DestroyArena(work.frame_arena);
+	}
+
+	work.splatter =
+	    CreateSplatter(BENCH_WIDTH, BENCH_HEIGHT, BENCH_SPLAT_POINTS);
+	if (work.splatter != NULL) {
+		char name[96];
+		double ms = time_submit(name, "splat", 0, submit_splat, &work);
+		emit(name, "ms/frame", ms, ", \"points\": %llu",
+		     (unsigned long long)BENCH_SPLAT_POINTS);
+		DestroySplatter(work.splatter);
+	}
+}
+
+// Peak bytes per tag over the whole run, and the GL calls if counted.
+static void write_memory_and_gl_stats(void) {
+	MemoryStats memory = GetMemoryStats();
+	fprintf(out, "  \"memory\": {\n");
+	for (int t = 0; t < MEMORY_TAG_COUNT; t++) {
+		fprintf(out,
+		        "    \"%s\": {\"cpu_peak_bytes\": %llu, "
+		        "\"gpu_peak_bytes\": %llu},\n",
+		        memory_tag_names[t], (unsigned long long)memory.cpu[t].peak,
+		        (unsigned long long)memory.gpu[t].peak);
+	}
+	fprintf(out,
+	        "    \"total\": {\"cpu_peak_bytes\": %llu, \"gpu_peak_bytes\": "
+	        "%llu},\n    \"peak_rss_bytes\": %llu\n  }",
+	        (unsigned long long)memory.cpu_total.peak,
+	        (unsigned long long)memory.gpu_total.peak,
+	        (unsigned long long)memory.peak_rss);
+
+	if (GLStatsEnabled()) {
+		GLStatsSummary gl = GetGLStats();
+		fprintf(out,
+		        ",\n  \"gl_stats\": {\"frames\": %llu, \"calls_per_frame\": "
+		        "%.6g, \"buffer_bytes_per_frame\": %.6g, "
+		        "\"uniform_bytes_per_frame\": %.6g, "
+		        "\"texture_bytes_per_frame\": %.6g, "
+		        "\"performance_warnings\": %llu, \"errors\": %llu}",
+		        (unsigned long long)gl.frames, gl.calls, gl.buffer_bytes,
+		        gl.uniform_bytes, gl.texture_bytes,
+		        (unsigned long long)gl.performance_warnings,
+		        (unsigned long long)gl.errors);
+	}
+	fprintf(out, "\n");
+}
+
+int main(int argc, char *argv[]) {
+	const char *path = argc > 1 ? argv[1] : BENCH_JSON;
+	out = fopen(path, "w");
+	if (out == NULL) {
+		perror("Could not open the benchmark results file");
+		return 1;
+	}
+
+	// Without a GL context only the CPU benchmarks run
+	Headless *headless = CreateHeadless(BENCH_WIDTH, BENCH_HEIGHT);
+	if (headless == NULL) {
+		printf("No GL context, skipping the shader and submission "
+		       "benchmarks\n");
+	}
+
+	fprintf(out, "{\n");
+	write_machine(headless);
+	fprintf(out, "  \"benchmarks\": [");
+
+	bench_generate();
+	bench_camera();
+	if (headless != NULL) {
+		bench_shaders();
+		bench_submit();
+	}
+
+	fprintf(out, "\n  ],\n");
+	write_memory_and_gl_stats();
+	fprintf(out, "}\n");
+	fclose(out);
+
+	if (headless != NULL) {
+		DestroyHeadless(headless);
+	}
+	printf("Benchmark results written to %s\n", path);
+	return 0;
+}
@@ -0,0 +1,500 @@
+#include <SDL3/SDL.h>
+#include <SDL3/SDL_main.h>
+#include <cglm/cglm.h>
+#include <glad/glad.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "arena/arena.h"
+#include "blocks/blocks.h"
+#include "camera/camera.h"
+#include "headless/headless.h"
+#include "memory/memory.h"
+#include "recursive/recursive.h"
+#include "splat/splat.h"
+
+/**
+ * Golden-image test of the render paths, run by `make golden`.
+ *
+ *     golden.out [--record] [OUTPUT_DIR]
+ *
+ * Every pose is drawn at every depth by the reference path (the recursive
+ * draw_serpinskis_triangle) and then by every other path, in the headless
+ * framebuffer. The reference is compared against its image stored in
+ * GOLDEN_REFERENCE_DIR, which only --record writes; a missing one fails.
+ * Every other path is compared against the reference drawn in the same run,
+ * so they have to match it exactly on any driver.
+ *
+ * A pixel differs if one of its channels is off by more than
+ * GOLDEN_CHANNEL_TOLERANCE, and an image fails if more than
+ * GOLDEN_MAX_DIFFERENT of its pixels do, which leaves room for triangle
+ * edges rasterized from slightly different transforms. The splat path draws
+ * the limit set as points, not pyramids, so it is only checked for points
+ * outside the reference's silhouette.
+ *
+ * Every path's image and a diff image (the differing pixels in red over the
+ * faded reference) are written to OUTPUT_DIR, and its frame time printed
+ * next to the result. Exits with 1 if any image failed or any path couldn't
+ * be drawn, so nothing passes untested.
+ */
+
+// Where the reference images are stored, from the repository root
+#define GOLDEN_REFERENCE_DIR "bench/golden"
+
+// Where the images and diffs are written unless a path is given
+#define GOLDEN_OUTPUT_DIR "golden"
+
+#define GOLDEN_WIDTH 400
+#define GOLDEN_HEIGHT 400
+
+// Block depth of the instanced paths, so the deeper ones are really two
+// levels
+#define GOLDEN_BLOCK_DEPTH 3
+
+#define GOLDEN_CHANNEL_TOLERANCE 8
+#define GOLDEN_MAX_DIFFERENT 0.001
+
+// Fraction of the splatted pixels allowed outside the reference
+#define GOLDEN_SPLAT_MAX_OUTSIDE 0.01
+
+// A pixel is covered if a channel is below this, the background is white
+#define GOLDEN_COVERED 240
+
+#define GOLDEN_SPLAT_POINTS 2000000ULL
+
+// Frames drawn to time each path
+#define GOLDEN_TIMING_FRAMES 10
+
+typedef enum GoldenPathKind {
+	GOLDEN_RECURSIVE,
+	GOLDEN_BLOCKS,
+	GOLDEN_SPLAT,
+} GoldenPathKind;
+
+typedef struct GoldenPath {
+	const char *name;
+	const char *file; // `name` as used in file names
+	GoldenPathKind kind;
+	bool front_to_back;
+	bool cull;
+	bool pull;
+	bool merge_faces;
+} GoldenPath;
+
+// The reference comes first
+static const GoldenPath paths[] = {
+    {"recursive", "recursive", GOLDEN_RECURSIVE, false, false, false, false},
+    {"recursive front-to-back", "recursive-front-to-back", GOLDEN_RECURSIVE,
+     true, false, false, false},
+    {"instanced", "instanced", GOLDEN_BLOCKS, false, false, false, true},
+    {"instanced unmerged", "instanced-unmerged", GOLDEN_BLOCKS, false, false,
+     false, false},
+    {"instanced culled", "instanced-culled", GOLDEN_BLOCKS, false, true, false,
+     true},
+    {"instanced culled front-to-back", "instanced-culled-front-to-back",
+     GOLDEN_BLOCKS, true, true, false, true},
+    {"instanced pulled", "instanced-pulled", GOLDEN_BLOCKS, false, false, true,
+     true},
+    {"splat", "splat", GOLDEN_SPLAT, false, false, false, false},
+};
+#define GOLDEN_PATH_COUNT (int)(sizeof(paths) / sizeof(paths[0]))
+
+// Camera poses: the app's starting view, from above at an angle, and a
+// close-up with most of the fractal outside the frustum
+static const float poses[][3][3] = {
+    {{0.0f, 0.0f, 3.0f}, {0.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}},
+    {{1.2f, 0.9f, 1.6f}, {0.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}},
+    {{0.35f, 0.1f, 0.55f}, {0.2f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}},
+};
+#define GOLDEN_POSE_COUNT (int)(sizeof(poses) / sizeof(poses[0]))
+
+static const int depths[] = {2, 4, 6};
+#define GOLDEN_DEPTH_COUNT (int)(sizeof(depths) / sizeof(depths[0]))
+
+// What every path draws
+typedef struct GoldenScene {
+	mat4 view;
+	mat4 perspective;
+	mat4 view_proj;
+	float eye[3];
+	int depth;
+
+	RecursiveRenderer *recursive;
+	BlockRenderer *blocks;
+	Arena *frame_arena;
+	Splatter *splatter;
+} GoldenScene;
+
+// How an image differs from the one expected
+typedef struct ImageDiff {
+	Uint64 compared;    // Pixels compared, only the covered ones for splats
+	Uint64 different;   // Pixels that differ
+	int max_difference; // Largest channel difference
+} ImageDiff;
+
+static void set_pose(GoldenScene *scene, int pose) {
+	Camera *camera = CreateCamera((float *)poses[pose][0],
+	                              (float *)poses[pose][1],
+	                              (float *)poses[pose][2]);
+	GetCameraViewMatrix(camera, scene->view);
+	glm_vec3_copy(camera->pos, scene->eye);
+	DestroyCamera(camera);
+
+	glm_perspective(glm_rad(45.0f), (float)GOLDEN_WIDTH / GOLDEN_HEIGHT, 0.1f,
+	                100.0f, scene->perspective);
+	glm_mat4_mul(scene->perspective, scene->view, scene->view_proj);
+}
+
+// Set up the renderer `path` draws with. Returns false if it's unavailable.
+static bool use_path(GoldenScene *scene, const GoldenPath *path) {
+	switch (path->kind) {
+	case GOLDEN_RECURSIVE:
+		return scene->recursive != NULL;
+	case GOLDEN_BLOCKS:
+		if (scene->blocks == NULL ||
+		    (path->pull && !BlockRendererCanPull(scene->blocks))) {
+			return false;
+		}
+		SetBlockRendererMergeFaces(scene->blocks, path->merge_faces);
+		SetBlockRendererDepth(scene->blocks, scene->depth,
+		                      GOLDEN_BLOCK_DEPTH);
+		scene->blocks->cull = path->cull;
+		scene->blocks->front_to_back = path->front_to_back;
+		scene->blocks->pull = path->pull;
+		return true;
+	case GOLDEN_SPLAT:
+		return scene->splatter != NULL;
+	}
+	return false;
+}
+
+static void draw_path(GoldenScene *scene, const GoldenPath *path) {
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	switch (path->kind) {
+	case GOLDEN_RECURSIVE:
+		DrawRecursive(scene->recursive, scene->depth, scene->view,
+		              scene->perspective,
+		              path->front_to_back ? scene->eye : NULL);
+		break;
+	case GOLDEN_BLOCKS:
+		ResetArena(scene->frame_arena);
+		DrawBlocks(scene->blocks, scene->view, scene->perspective);
+		break;
+	case GOLDEN_SPLAT:
+		// Splat every frame, the work being timed
+		scene->splatter->valid = false;
+		UpdateSplatter(scene->splatter, scene->view_proj);
+		DrawSplatter(scene->splatter);
+		break;
+	}
+}
+
+// Average milliseconds per frame of `path`, finished on the GPU.
+static double time_path(GoldenScene *scene, const GoldenPath *path) {
+	glFinish();
+	Uint64 start = SDL_GetTicksNS();
+	for (int i = 0; i < GOLDEN_TIMING_FRAMES; i++) {
+		draw_path(scene, path);
+	}
+	glFinish();
+	return (double)(SDL_GetTicksNS() - start) / GOLDEN_TIMING_FRAMES / 1e6;
+}
+
+static bool save_image(const char *path, Uint8 *pixels) {
+	SDL_Surface *surface =
+	    SDL_CreateSurfaceFrom(GOLDEN_WIDTH, GOLDEN_HEIGHT,
+	                          SDL_PIXELFORMAT_RGBX32, pixels, GOLDEN_WIDTH * 4);
+	if (surface == NULL || !SDL_SaveBMP(surface, path)) {
+		printf("Could not save %s: %s\n", path, SDL_GetError());
+		SDL_DestroySurface(surface);
+		return false;
+	}
+	SDL_DestroySurface(surface);
+	return true;
+}
+
+// Load the image at `path` into `pixels`. Returns false if it can't be read
+// or is the wrong size.
+static bool load_image(const char *path, Uint8 *pixels) {
+	SDL_Surface *loaded = SDL_LoadBMP(path);
+	if (loaded == NULL) {
+		return false;
+	}
+	SDL_Surface *surface = SDL_ConvertSurface(loaded, SDL_PIXELFORMAT_RGBX32);
+	SDL_DestroySurface(loaded);
+	if (surface == NULL) {
+		return false;
+	}
+
+	bool fits = surface->w == GOLDEN_WIDTH && surface->h == GOLDEN_HEIGHT;
+	if (fits) {
+		for (int y = 0; y < GOLDEN_HEIGHT; y++) {
+			memcpy(pixels + (size_t)y * GOLDEN_WIDTH * 4,
+			       (Uint8 *)surface->pixels + (size_t)y * surface->pitch,
+			       (size_t)GOLDEN_WIDTH * 4);
+		}
+	} else {
+		printf("%s is %dx%d, not %dx%d\n", path, surface->w, surface->h,
+		       GOLDEN_WIDTH, GOLDEN_HEIGHT);
+	}
+	SDL_DestroySurface(surface);
+	return fits;
+}
+
+static int channel_difference(const Uint8 *a, const Uint8 *b) {
+	int max = 0;
+	for (int c = 0; c < 3; c++) {
+		int difference = abs((int)a[c] - (int)b[c]);
+		if (difference > max) {
+			max = difference;
+		}
+	}
+	return max;
+}
+
+static bool covered(const Uint8 *pixel) {
+	return pixel[0] < GOLDEN_COVERED || pixel[1] < GOLDEN_COVERED ||
+	       pixel[2] < GOLDEN_COVERED;
+}
+
+// The diff image's pixel: red if it differs, the faded expected one if not.
+static void write_diff(Uint8 *diff, const Uint8 *expected, bool different) {
+	for (int c = 0; c < 3; c++) {
+		diff[c] = different ? (c == 0 ? 255 : 0) : 192 + expected[c] / 4;
+	}
+	diff[3] = 255;
+}
+
+// Compare every pixel of `actual` against `expected`.
+static ImageDiff compare_images(const Uint8 *expected, const Uint8 *actual,
+                                Uint8 *diff) {
+	ImageDiff result = {0, 0, 0};
+	for (size_t i = 0; i < (size_t)GOLDEN_WIDTH * GOLDEN_HEIGHT; i++) {
+		int difference = channel_difference(&expected[i * 4], &actual[i * 4]);
+		bool different = difference > GOLDEN_CHANNEL_TOLERANCE;
+		if (difference > result.max_difference) {
+			result.max_difference = difference;
+		}
+		result.compared++;
+		result.different += different;
+		write_diff(&diff[i * 4], &expected[i * 4], different);
+	}
+	return result;
+}
+
+/**
+ * Compare the coverage of `actual` against `expected`: a covered pixel of
+ * `actual` differs if no pixel around it is covered in `expected`. Only
+ * finds extra pixels, points can't cover every pixel of the silhouette.
+ */
+static ImageDiff compare_coverage(const Uint8 *expected, const Uint8 *actual,
+                                  Uint8 *diff) {
+	ImageDiff result = {0, 0, 0};
+	for (int y = 0; y < GOLDEN_HEIGHT; y++) {
+		for (int x = 0; x < GOLDEN_WIDTH; x++) {
+			size_t i = (size_t)y * GOLDEN_WIDTH + x;
+			bool outside = false;
+			if (covered(&actual[i * 4])) {
+				outside = true;
+				for (int dy = -1; dy <= 1 && outside; dy++) {
+					for (int dx = -1; dx <= 1 && outside; dx++) {
+						int nx = x + dx;
+						int ny = y + dy;
+						size_t n = (size_t)ny * GOLDEN_WIDTH + nx;
+						outside = nx < 0 || nx >= GOLDEN_WIDTH || ny < 0 ||
+						          ny >= GOLDEN_HEIGHT ||
+						          !covered(&expected[n * 4]);
+					}
+				}
+				result.compared++;
+			}
+			result.different += outside;
+			write_diff(&diff[i * 4], &expected[i * 4], outside);
+		}
+	}
+	result.max_difference = result.different > 0 ? 255 : 0;
+	return result;
+}
+
+/**
+ * Write the image and diff of `path` and print the result with its frame
+ * time `ms`. Returns whether it passed.
+ */
+static bool report(const char *output_dir, int pose, int depth,
+                   const GoldenPath *path, const char *against, ImageDiff diff,
+                   double max_different, Uint8 *actual, Uint8 *diff_image,
+                   double ms, double reference_ms) {
+	char image_path[512];
+	snprintf(image_path, sizeof(image_path), "%s/pose%d-depth%d-%s.bmp",
+	         output_dir, pose, depth, path->file);
+	save_image(image_path, actual);
+	snprintf(image_path, sizeof(image_path), "%s/pose%d-depth%d-%s-diff.bmp",
+	         output_dir, pose, depth, path->file);
+	save_image(image_path, diff_image);
+
+	double fraction =
+	    diff.compared > 0 ? (double)diff.different / diff.compared : 0.0;
+	bool passed = fraction <= max_different;
+	printf("%4d %5d  %-32s %-10s %9.3f %7.2fx %8.4f%% %4d  %s\n", pose, depth,
+	       path->name, against, ms, reference_ms / ms, 100.0 * fraction,
+	       diff.max_difference, passed ? "ok" : "FAILED");
+	return passed;
+}
+
+int main(int argc, char *argv[]) {
+	bool recording = argc > 1 && strcmp(argv[1], "--record") == 0;
+	const char *output_dir =
+	    argc > 1 + recording ? argv[1 + recording] : GOLDEN_OUTPUT_DIR;
+
+	Headless *headless = CreateHeadless(GOLDEN_WIDTH, GOLDEN_HEIGHT);
+	if (headless == NULL) {
+		printf("No GL context, can't draw the golden images\n");
+		return 1;
+	}
+	glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
+
+	if (!SDL_CreateDirectory(output_dir) ||
+	    !SDL_CreateDirectory(GOLDEN_REFERENCE_DIR)) {
+		printf("Could not create the image directories: %s\n",
+		       SDL_GetError());
+		DestroyHeadless(headless);
+		return 1;
+	}
+
+	size_t image_bytes = (size_t)GOLDEN_WIDTH * GOLDEN_HEIGHT * 4;
+	Uint8 *reference = (Uint8 *)TaggedMalloc(MEMORY_APP, image_bytes);
+	Uint8 *stored = (Uint8 *)TaggedMalloc(MEMORY_APP, image_bytes);
+	Uint8 *actual = (Uint8 *)TaggedMalloc(MEMORY_APP, image_bytes);
+	Uint8 *diff_image = (Uint8 *)TaggedMalloc(MEMORY_APP, image_bytes);
+	if (reference == NULL || stored == NULL || actual == NULL ||
+	    diff_image == NULL) {
+		perror("Could not allocate memory for the images");
+		TaggedFree(reference);
+		TaggedFree(stored);
+		TaggedFree(actual);
+		TaggedFree(diff_image);
+		DestroyHeadless(headless);
+		return 1;
+	}
+
+	GoldenScene scene;
+	memset(&scene, 0, sizeof(scene));
+	scene.recursive = CreateRecursiveRenderer();
+	scene.frame_arena = CreateArena("frame", FRAME_ARENA_SIZE);
+	if (scene.frame_arena != NULL) {
+		scene.blocks = CreateBlockRenderer(scene.frame_arena);
+	}
+	scene.splatter =
+	    CreateSplatter(GOLDEN_WIDTH, GOLDEN_HEIGHT, GOLDEN_SPLAT_POINTS);
+
+	printf("%4s %5s  %-32s %-10s %9s %8s %9s %4s\n", "pose", "depth", "path",
+	       "against", "ms/frame", "speedup", "differ", "max");
+	int failures = 0;
+	int skipped = 0;
+	int missing = 0;
+	for (int pose = 0; pose < GOLDEN_POSE_COUNT; pose++) {
+		set_pose(&scene, pose);
+		for (int d = 0; d < GOLDEN_DEPTH_COUNT; d++) {
+			scene.depth = depths[d];
+			double reference_ms = 0.0;
+			for (int p = 0; p < GOLDEN_PATH_COUNT; p++) {
+				const GoldenPath *path = &paths[p];
+				if (!use_path(&scene, path)) {
+					printf("%4d %5d  %-32s not available, skipped\n", pose,
+					       scene.depth, path->name);
+					// Nothing to compare against without the reference
+					skipped += p == 0 ? GOLDEN_PATH_COUNT : 1;
+					if (p == 0) {
+						break;
+					}
+					continue;
+				}
+				draw_path(&scene, path);
+				ReadHeadlessPixels(headless, actual);
+				double ms = time_path(&scene, path);
+
+				if (p > 0) {
+					ImageDiff diff =
+					    path->kind == GOLDEN_SPLAT
+					        ? compare_coverage(reference, actual, diff_image)
+					        : compare_images(reference, actual, diff_image);
+					failures += !report(
+					    output_dir, pose, scene.depth, path, "reference",
+					    diff,
+					    path->kind == GOLDEN_SPLAT ? GOLDEN_SPLAT_MAX_OUTSIDE
+					                               : GOLDEN_MAX_DIFFERENT,
+					    actual, diff_image, ms, reference_ms);
+					continue;
+				}
+
+				// The reference itself, against the stored image
+				reference_ms = ms;
+				memcpy(reference, actual, image_bytes);
+				char stored_path[512];
+				snprintf(stored_path, sizeof(stored_path),
+				         "%s/pose%d-depth%d.bmp", GOLDEN_REFERENCE_DIR, pose,
+				         scene.depth);
+				if (recording) {
+					if (!save_image(stored_path, reference)) {
+						failures++;
+						continue;
+					}
+					printf("Recorded %s\n", stored_path);
+					memcpy(stored, reference, image_bytes);
+				} else if (!load_image(stored_path, stored)) {
+					printf("%4d %5d  %-32s no reference image %s, FAILED\n",
+					       pose, scene.depth, path->name, stored_path);
+					// Still written, to look at before recording it
+					snprintf(stored_path, sizeof(stored_path),
+					         "%s/pose%d-depth%d-%s.bmp", output_dir, pose,
+					         scene.depth, path->file);
+					save_image(stored_path, reference);
+					missing++;
+					failures++;
+					continue;
+				}
+				ImageDiff diff = compare_images(stored, actual, diff_image);
+				failures += !report(output_dir, pose, scene.depth, path,
+				                    "stored", diff, GOLDEN_MAX_DIFFERENT,
+				                    actual, diff_image, ms, reference_ms);
+			}
+		}
+	}
+
+	if (scene.splatter != NULL) {
+		DestroySplatter(scene.splatter);
+	}
+	if (scene.blocks != NULL) {
+		DestroyBlockRenderer(scene.blocks);
+	}
+	if (scene.frame_arena != NULL) {
+		DestroyArena(scene.frame_arena);
+	}
+	if (scene.recursive != NULL) {
+		DestroyRecursiveRenderer(scene.recursive);
+	}
+	TaggedFree(reference);
+	TaggedFree(stored);
+	TaggedFree(actual);
+	TaggedFree(diff_image);
+	DestroyHeadless(headless);
+
+	printf("Images and diffs written to %s\n", output_dir);
+	if (missing > 0) {
+		printf("%d reference image(s) missing from %s, record them with "
+		       "`make golden-record`\n",
+		       missing, GOLDEN_REFERENCE_DIR);
+	}
+	if (skipped > 0) {
+		printf("%d image(s) skipped, their path isn't available\n", skipped);
+	}
+	if (failures > 0) {
+		printf("%d image(s) failed\n", failures);
+	}
+	if (failures > 0 || skipped > 0) {
+		return 1;
+	}
+	printf("All images match\n");
+	return 0;
+}
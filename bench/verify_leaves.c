@@ -0,0 +1,22 @@
+#include <SDL3/SDL.h>
+#include <SDL3/SDL_main.h>
+#include <stdio.h>
+
+#include "ifs/ifs.h"
+
+/**
+ * Check of the pyramid leaf tables baked at build time, run by
+ * `make verify-leaves`. Exits with 1 if any depth doesn't match what the
+ * runtime generator produces (see VerifyBakedLeaves).
+ */
+int main(int argc, char *argv[]) {
+	(void)argc;
+	(void)argv;
+	if (!VerifyBakedLeaves()) {
+		printf("The baked leaf tables are wrong, rebuild them with "
+		       "`make clean`\n");
+		return 1;
+	}
+	printf("The baked leaf tables match the generator\n");
+	return 0;
+}
@@ -0,0 +1,13 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec2 uv;
+in vec4 textColor;
+
+// Glyph coverage, see hud.h
+uniform sampler2D atlas;
+
+void main()
+{
+    FragColor = vec4(textColor.rgb, textColor.a * texture(atlas, uv).r);
+}
\ No newline at end of file
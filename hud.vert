@@ -0,0 +1,20 @@
+#version 330
+
+// Pixel positions, atlas coordinates and normalized RGBA8 colors, see hud.h
+layout (location=0) in vec2 pos;
+layout (location=1) in vec2 atlasUV;
+layout (location=2) in vec4 color;
+
+out vec2 uv;
+out vec4 textColor;
+
+// Window size in pixels, the positions are in pixels with y down
+uniform vec2 screen;
+
+void main()
+{
+    vec2 ndc = pos / screen * 2.0 - 1.0;
+    gl_Position = vec4(ndc.x, -ndc.y, 0.0, 1.0);
+    uv = atlasUV;
+    textColor = color;
+}
\ No newline at end of file
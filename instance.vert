@@ -0,0 +1,17 @@
+#version 330
+
+// Half float positions and normalized RGBA8 colors, see mesh.h
+layout (location=0) in vec3 coord;
+layout (location=1) in vec3 color;
+layout (location=2) in vec4 instance; // xyz = center, w = scale
+
+uniform mat4 view;
+uniform mat4 perspective;
+
+out vec3 outColor;
+
+void main()
+{
+    gl_Position = perspective * view * vec4(coord * instance.w + instance.xyz, 1.0);
+    outColor = color;
+}
\ No newline at end of file
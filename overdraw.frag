@@ -0,0 +1,29 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec2 uv;
+
+// Fragments drawn to each pixel, in alpha, see overdraw.h
+uniform sampler2D counts;
+
+// Count shown as white
+uniform float max_layers;
+
+// Blue for one layer, then green, yellow and red
+const vec3 ramp[5] = vec3[](vec3(0.0, 0.0, 1.0), vec3(0.0, 1.0, 0.0),
+                            vec3(1.0, 1.0, 0.0), vec3(1.0, 0.0, 0.0),
+                            vec3(1.0));
+
+void main()
+{
+    float layers = texture(counts, uv).a;
+    if (layers < 0.5)
+    {
+        FragColor = vec4(0.0, 0.0, 0.0, 1.0);
+        return;
+    }
+
+    float t = clamp((layers - 1.0) / (max_layers - 1.0), 0.0, 1.0) * 4.0;
+    int i = int(min(t, 3.0));
+    FragColor = vec4(mix(ramp[i], ramp[i + 1], t - float(i)), 1.0);
+}
\ No newline at end of file
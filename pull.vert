@@ -0,0 +1,66 @@
+#version 330
+
+// Vertex pulling: the base pyramid comes from the constant tables below,
+// indexed by gl_VertexID, so only the instance needs an attribute.
+
+layout (location=2) in vec4 instance; // xyz = center, w = scale
+
+uniform mat4 view;
+uniform mat4 perspective;
+
+// Depth of the baked block. Vertex 18 * p + i is vertex i of pyramid p, whose
+// base-5 digits give its place in the block, like the leaves on the CPU.
+uniform int block_depth;
+
+// Corners of the pyramid in vertices.h, in child traversal order (top,
+// left_front, left_back, right_front, right_back). They are also the child
+// offsets, in units of the child's scale.
+const vec3 corners[5] = vec3[5](
+    vec3(0.0, 0.5, 0.0),
+    vec3(-0.5, -0.5, 0.5),
+    vec3(-0.5, -0.5, -0.5),
+    vec3(0.5, -0.5, 0.5),
+    vec3(0.5, -0.5, -0.5)
+);
+
+// The 18 vertices of vertices.h as corner indices
+const int indices[18] = int[18](
+    0, 4, 3,
+    0, 4, 2,
+    0, 2, 1,
+    0, 3, 1,
+    4, 3, 2,
+    2, 1, 3
+);
+
+// One color per triangle, the base is two cyan triangles
+const vec3 colors[6] = vec3[6](
+    vec3(0.0, 0.0, 1.0),
+    vec3(1.0, 1.0, 0.0),
+    vec3(0.0, 1.0, 0.0),
+    vec3(1.0, 0.0, 0.0),
+    vec3(0.0, 1.0, 1.0),
+    vec3(0.0, 1.0, 1.0)
+);
+
+out vec3 outColor;
+
+void main()
+{
+    int vertex = gl_VertexID % 18;
+    int pyramid = gl_VertexID / 18;
+
+    // Walk the digits from the deepest level up, doubling the scale
+    float scale = exp2(-float(block_depth));
+    vec3 center = vec3(0.0);
+    for (int i = 0; i < block_depth; i++) {
+        center += corners[pyramid % 5] * scale;
+        pyramid /= 5;
+        scale *= 2.0;
+    }
+
+    vec3 coord = corners[indices[vertex]] * exp2(-float(block_depth)) + center;
+
+    gl_Position = perspective * view * vec4(coord * instance.w + instance.xyz, 1.0);
+    outColor = colors[vertex / 3];
+}
\ No newline at end of file
@@ -1,5 +1,6 @@
 #version 330
 
+// Half float positions and normalized RGBA8 colors, see mesh.h
 layout (location=0) in vec3 coord;
 layout (location=1) in vec3 color;
 
@@ -0,0 +1,13 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec2 uv;
+
+uniform sampler2D density;
+
+void main()
+{
+    // Log density, already normalized to [0, 1] on the CPU.
+    float d = texture(density, uv).r;
+    FragColor = vec4(mix(vec3(1.0), vec3(0.05, 0.1, 0.45), d), 1.0);
+}
\ No newline at end of file
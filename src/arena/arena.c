@@ -0,0 +1,111 @@
+#include "arena/arena.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "memory/memory.h"
+
+// Overwrite released bytes in debug builds.
+static void poison(unsigned char *data, size_t size) {
+#ifndef NDEBUG
+	memset(data, ARENA_POISON, size);
+#else
+	(void)data;
+	(void)size;
+#endif
+}
+
+Arena *CreateArena(const char *name, size_t capacity) {
+	Arena *arena = (Arena *)TaggedCalloc(MEMORY_ARENAS, 1, sizeof(Arena));
+	if (arena == NULL) {
+		perror("Could not allocate memory for arena");
+		return NULL;
+	}
+
+	arena->base = (unsigned char *)TaggedMalloc(MEMORY_ARENAS, capacity);
+	if (arena->base == NULL) {
+		perror("Could not allocate memory for arena block");
+		TaggedFree(arena);
+		return NULL;
+	}
+
+	arena->name = name;
+	arena->capacity = capacity;
+	poison(arena->base, capacity);
+	return arena;
+}
+
+void DestroyArena(Arena *arena) {
+	TaggedFree(arena->base);
+	TaggedFree(arena);
+}
+
+void *ArenaAlloc(Arena *arena, size_t size, size_t alignment) {
+	uintptr_t address = (uintptr_t)arena->base + arena->used;
+	size_t padding = (size_t)(-address & (alignment - 1));
+	size_t end = arena->used + padding + size;
+
+	if (end > arena->high_water) {
+		arena->high_water = end;
+	}
+	if (end > arena->capacity) {
+		arena->failures++;
+		return NULL;
+	}
+
+	void *data = arena->base + arena->used + padding;
+	arena->used = end;
+	return data;
+}
+
+bool ArenaIsLast(const Arena *arena, const void *data, size_t size) {
+	return data != NULL &&
+	       (const unsigned char *)data + size == arena->base + arena->used;
+}
+
+void *ArenaResize(Arena *arena, void *data, size_t old_size, size_t new_size,
+                  size_t alignment) {
+	if (data == NULL) {
+		return ArenaAlloc(arena, new_size, alignment);
+	}
+
+	if (ArenaIsLast(arena, data, old_size)) {
+		size_t start = (size_t)((unsigned char *)data - arena->base);
+		size_t end = start + new_size;
+		if (end > arena->high_water) {
+			arena->high_water = end;
+		}
+		if (end > arena->capacity) {
+			arena->failures++;
+			return NULL;
+		}
+		if (new_size < old_size) {
+			poison((unsigned char *)data + new_size, old_size - new_size);
+		}
+		arena->used = end;
+		return data;
+	}
+
+	void *moved = ArenaAlloc(arena, new_size, alignment);
+	if (moved == NULL) {
+		return NULL;
+	}
+	memcpy(moved, data, old_size < new_size ? old_size : new_size);
+	poison((unsigned char *)data, old_size);
+	return moved;
+}
+
+void ResetArena(Arena *arena) {
+	poison(arena->base, arena->used);
+	arena->used = 0;
+	arena->resets++;
+}
+
+void PrintArenaStats(const Arena *arena) {
+	printf("Arena %s: %zu bytes, high-water mark %zu bytes (%.1f%%), %llu "
+	       "failed allocations\n",
+	       arena->name, arena->capacity, arena->high_water,
+	       100.0 * (double)arena->high_water / (double)arena->capacity,
+	       (unsigned long long)arena->failures);
+}
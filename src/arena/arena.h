@@ -0,0 +1,70 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <SDL3/SDL.h>
+
+// Size of the frame arena created in main.c.
+#define FRAME_ARENA_SIZE (1 << 20)
+
+// Byte written over released memory in debug builds (without NDEBUG), so
+// reads of stale per-frame data show up as 0xdddddddd instead of working by
+// accident.
+#define ARENA_POISON 0xdd
+
+/**
+ * Linear allocator for transient data.
+ *
+ * Allocations bump a pointer into one block reserved up front, and are all
+ * released together by ResetArena, so nothing is malloc'd or freed while it
+ * is in use. The frame arena in main.c is reset at the start of every frame,
+ * so anything allocated from it only lives until the next one.
+ *
+ * An arena is not thread-safe. Workers running in parallel should each get
+ * their own arena, reset by whoever owns the workers once they are idle.
+ */
+typedef struct Arena {
+	const char *name; // For printing
+	unsigned char *base;
+	size_t capacity;
+	size_t used;
+
+	// Statistics
+	Uint64 resets;     // Also tells apart allocations from different frames
+	size_t high_water; // Most bytes needed between two resets
+	Uint64 failures;   // Allocations that didn't fit
+} Arena;
+
+// Create an arena holding up to `capacity` bytes.
+Arena *CreateArena(const char *name, size_t capacity);
+
+// Free an arena and its memory.
+void DestroyArena(Arena *arena);
+
+/**
+ * Allocate `size` bytes aligned to `alignment` (a power of two).
+ *
+ * Returns NULL if the arena is full. The bytes that would have been needed
+ * still count towards the high-water mark, so it shows how big the arena
+ * should be.
+ */
+void *ArenaAlloc(Arena *arena, size_t size, size_t alignment);
+
+/**
+ * Grow or shrink an allocation of `old_size` bytes to `new_size`.
+ *
+ * The last allocation is resized in place. Anything else is copied to a new
+ * allocation. Returns NULL, leaving `data` untouched, if it doesn't fit.
+ */
+void *ArenaResize(Arena *arena, void *data, size_t old_size, size_t new_size,
+                  size_t alignment);
+
+// Whether `data`, `size` bytes long, is the last allocation made.
+bool ArenaIsLast(const Arena *arena, const void *data, size_t size);
+
+// Release every allocation at once.
+void ResetArena(Arena *arena);
+
+// Print the capacity, high-water mark and failed allocations.
+void PrintArenaStats(const Arena *arena);
+
+#endif // ARENA_H
@@ -0,0 +1,625 @@
+#include "blocks/blocks.h"
+
+#include <glad/glad.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "memory/memory.h"
+#include "mesh/mesh.h"
+#include "query/query.h"
+#include "trace/trace.h"
+#include "vcache/vcache.h"
+
+// Frames drawn per block depth by BenchmarkBlocks
+#define BENCHMARK_FRAMES 20
+
+// Size of a vertex in the `vertices.h` layout, before packing
+#define UNPACKED_VERTEX_SIZE (sizeof(float) * 6)
+
+/**
+ * Bake every leaf primitive of a depth `block_depth` `ifs` into one packed
+ * vertex array, with coplanar faces merged if `merge` is set.
+ */
+static PackedVertex *bake_block(const IFS *ifs, int block_depth, bool merge,
+                                Uint64 *vertices) {
+	LeafBuffer *leaves = CreateIFSLeafBuffer(ifs, block_depth);
+	if (leaves == NULL) {
+		return NULL;
+	}
+
+	int base_vertices = ifs->base_vertex_count;
+	*vertices = leaves->count * base_vertices;
+	float *unpacked = (float *)TaggedMalloc(
+	    MEMORY_MESHES, UNPACKED_VERTEX_SIZE * (*vertices));
+	if (unpacked == NULL) {
+		perror("Could not allocate memory for block mesh");
+		DestroyLeafBuffer(leaves);
+		return NULL;
+	}
+
+	float *vertex = unpacked;
+	for (Uint64 i = 0; i < leaves->count; i++) {
+		const Leaf *leaf = &leaves->leaves[i];
+		for (int v = 0; v < base_vertices; v++) {
+			const float *in = &ifs->base_vertices[v * 6];
+			vertex[0] = in[0] * leaf->scale + leaf->center[0];
+			vertex[1] = in[1] * leaf->scale + leaf->center[1];
+			vertex[2] = in[2] * leaf->scale + leaf->center[2];
+			vertex[3] = in[3];
+			vertex[4] = in[4];
+			vertex[5] = in[5];
+			vertex += 6;
+		}
+	}
+	DestroyLeafBuffer(leaves);
+
+	if (merge) {
+		*vertices = MergeCoplanarFaces(unpacked, *vertices);
+	}
+
+	PackedVertex *mesh = (PackedVertex *)TaggedMalloc(
+	    MEMORY_MESHES, sizeof(PackedVertex) * (*vertices));
+	if (mesh == NULL) {
+		perror("Could not allocate memory for block mesh");
+	} else {
+		PackVertices(unpacked, *vertices, mesh);
+	}
+
+	TaggedFree(unpacked);
+	return mesh;
+}
+
+// Deepest block of `ifs` that fits in BLOCK_MAX_VERTICES, and no deeper than
+// `depth`.
+static int max_block_depth(const IFS *ifs, int depth) {
+	int block_depth = 0;
+	while (block_depth < depth &&
+	       (Uint64)ifs->base_vertex_count *
+	               IFSLeafCount(ifs, block_depth + 1) <=
+	           BLOCK_MAX_VERTICES) {
+		block_depth++;
+	}
+	return block_depth;
+}
+
+bool BlockRendererCanPull(const BlockRenderer *renderer) {
+	return renderer->ifs == &ifs_sierpinski_pyramid &&
+	       renderer->pull_program.program != NULL;
+}
+
+/**
+ * Weld the baked `vertices`, reorder the indices for the vertex cache if
+ * `renderer->optimize_vertex_cache` is set and the vertices for fetch order,
+ * and upload both. Takes ownership of `vertices`.
+ */
+static bool upload_block(BlockRenderer *renderer, PackedVertex *vertices,
+                         Uint64 count) {
+	PackedVertex *unique = (PackedVertex *)TaggedMalloc(
+	    MEMORY_MESHES, sizeof(PackedVertex) * count);
+	Uint32 *indices =
+	    (Uint32 *)TaggedMalloc(MEMORY_MESHES, sizeof(Uint32) * count);
+	Uint32 unique_count = 0;
+	if (unique == NULL || indices == NULL) {
+		perror("Could not allocate memory for block mesh");
+	} else {
+		unique_count = WeldVertices(vertices, count, unique, indices);
+	}
+	TaggedFree(vertices);
+	if (unique_count == 0) {
+		TaggedFree(unique);
+		TaggedFree(indices);
+		return false;
+	}
+
+	if (renderer->optimize_vertex_cache) {
+		OptimizeVertexCache(indices, count, unique_count,
+		                    renderer->vcache_size);
+		OptimizeVertexFetch(indices, count, unique, unique_count);
+	}
+	renderer->mesh_cache = SimulateVertexCache(indices, count, unique_count,
+	                                           renderer->vcache_size);
+
+	glBindBuffer(GL_ARRAY_BUFFER, renderer->mesh_vbo);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(PackedVertex) * unique_count, unique,
+	             GL_STATIC_DRAW);
+	TrackGPUMemory(MEMORY_MESHES, GPU_OBJECT_BUFFER, renderer->mesh_vbo,
+	               sizeof(PackedVertex) * unique_count);
+	// The element buffer binding is part of the VAO
+	glBindVertexArray(renderer->vao);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, renderer->mesh_ebo);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(Uint32) * count, indices,
+	             GL_STATIC_DRAW);
+	TrackGPUMemory(MEMORY_MESHES, GPU_OBJECT_BUFFER, renderer->mesh_ebo,
+	               sizeof(Uint32) * count);
+
+	TaggedFree(unique);
+	TaggedFree(indices);
+
+	renderer->mesh_vertices = unique_count;
+	renderer->mesh_indices = count;
+	return true;
+}
+
+// Vertices drawn per instance: the mesh's indices, or with pulling every
+// primitive of the block, unmerged, built by pull.vert.
+static Uint64 draw_count(const BlockRenderer *renderer, bool pull) {
+	return pull ? renderer->ifs->base_vertex_count *
+	                  IFSLeafCount(renderer->ifs, renderer->block_depth)
+	            : renderer->mesh_indices;
+}
+
+// One instanced draw of `count` vertices, indexed unless pulling.
+static void draw_instanced(Uint64 count, bool pull, Uint32 instances) {
+	if (pull) {
+		glDrawArraysInstanced(GL_TRIANGLES, 0, (GLsizei)count,
+		                      (GLsizei)instances);
+	} else {
+		glDrawElementsInstanced(GL_TRIANGLES, (GLsizei)count,
+		                        GL_UNSIGNED_INT, (void *)0,
+		                        (GLsizei)instances);
+	}
+}
+
+/**
+ * Submit every visible range with one glMultiDraw*Indirect call. Returns
+ * false, having drawn nothing, if the commands couldn't be allocated.
+ */
+static bool draw_indirect(BlockRenderer *renderer, Uint64 count, bool pull) {
+	VisibleRanges *visible = renderer->visible;
+	RingBuffer *ring = renderer->indirect_ring;
+
+	BeginRingFrame(ring);
+
+	size_t command_size = pull ? sizeof(DrawArraysIndirectCommand)
+	                           : sizeof(DrawElementsIndirectCommand);
+	size_t offset;
+	void *commands = AllocateRing(ring, command_size * visible->count,
+	                              sizeof(GLuint), &offset);
+	if (commands == NULL) {
+		printf("Could not allocate %u indirect draw commands, drawing the "
+		       "ranges one by one\n",
+		       visible->count);
+		EndRingFrame(ring);
+		return false;
+	}
+
+	for (Uint32 i = 0; i < visible->count; i++) {
+		const DrawRange *range = &visible->ranges[i];
+		if (pull) {
+			((DrawArraysIndirectCommand *)commands)[i] =
+			    (DrawArraysIndirectCommand){(GLuint)count, range->count, 0,
+			                                range->first};
+		} else {
+			((DrawElementsIndirectCommand *)commands)[i] =
+			    (DrawElementsIndirectCommand){(GLuint)count, range->count, 0,
+			                                  0, range->first};
+		}
+	}
+	CommitRing(ring);
+
+	// AllocateRing leaves the ring bound to GL_DRAW_INDIRECT_BUFFER
+	if (pull) {
+		glMultiDrawArraysIndirect(GL_TRIANGLES, (void *)offset,
+		                          visible->count, 0);
+	} else {
+		glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT,
+		                            (void *)offset, visible->count, 0);
+	}
+	renderer->draw_calls = 1;
+
+	EndRingFrame(ring);
+	return true;
+}
+
+// Fallback without multi-draw indirect: one draw per visible range, with the
+// instance attribute pointed at the range's first leaf.
+static void draw_ranges(BlockRenderer *renderer, Uint64 count, bool pull) {
+	VisibleRanges *visible = renderer->visible;
+
+	glBindBuffer(GL_ARRAY_BUFFER, renderer->instance_vbo);
+	for (Uint32 i = 0; i < visible->count; i++) {
+		glVertexAttribPointer(
+		    2, 4, GL_FLOAT, GL_FALSE, sizeof(Leaf),
+		    (void *)(sizeof(Leaf) * (size_t)visible->ranges[i].first));
+		draw_instanced(count, pull, visible->ranges[i].count);
+	}
+	glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(Leaf), (void *)0);
+	renderer->draw_calls = visible->count;
+}
+
+// Load a program and look up the uniforms the block shaders use.
+static BlockProgram load_block_program(const char *vert) {
+	BlockProgram program = {NULL, -1, -1, -1};
+
+	program.program = LoadShaderProgram(vert, "shader.frag");
+	if (program.program != NULL) {
+		program.view_uniform = glGetUniformLocation(*program.program, "view");
+		program.perspective_uniform =
+		    glGetUniformLocation(*program.program, "perspective");
+		program.block_depth_uniform =
+		    glGetUniformLocation(*program.program, "block_depth");
+	}
+
+	return program;
+}
+
+// Point attribute 2 of the bound VAO at the instance buffer.
+static void setup_instance_attribute(BlockRenderer *renderer) {
+	glBindBuffer(GL_ARRAY_BUFFER, renderer->instance_vbo);
+	glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(Leaf), (void *)0);
+	glVertexAttribDivisor(2, 1);
+	glEnableVertexAttribArray(2);
+}
+
+BlockRenderer *CreateBlockRenderer(Arena *frame_arena) {
+	BlockRenderer *renderer =
+	    (BlockRenderer *)TaggedCalloc(MEMORY_APP, 1, sizeof(BlockRenderer));
+	if (renderer == NULL) {
+		perror("Could not allocate memory for block renderer");
+		return NULL;
+	}
+
+	renderer->ifs = &ifs_sierpinski_pyramid;
+	renderer->merge_faces = true;
+	renderer->optimize_vertex_cache = true;
+	renderer->vcache_size = VertexCacheSize();
+	renderer->depth = -1;
+	renderer->block_depth = -1;
+
+	glGenVertexArrays(1, &renderer->vao);
+	glGenVertexArrays(1, &renderer->pull_vao);
+	glGenBuffers(1, &renderer->mesh_vbo);
+	glGenBuffers(1, &renderer->mesh_ebo);
+	glGenBuffers(1, &renderer->instance_vbo);
+
+	renderer->visible = CreateVisibleRanges(frame_arena);
+	if (gl_extensions.multi_draw_indirect) {
+		renderer->indirect_ring = CreateRingBuffer(
+		    GL_DRAW_INDIRECT_BUFFER, sizeof(DrawArraysIndirectCommand) * 256);
+	}
+
+	glBindVertexArray(renderer->vao);
+
+	glBindBuffer(GL_ARRAY_BUFFER, renderer->mesh_vbo);
+	SetupPackedVertexAttributes();
+
+	setup_instance_attribute(renderer);
+
+	// The pulling VAO only needs the instances
+	glBindVertexArray(renderer->pull_vao);
+	setup_instance_attribute(renderer);
+
+	renderer->mesh_program = load_block_program("instance.vert");
+	renderer->pull_program = load_block_program("pull.vert");
+
+	return renderer;
+}
+
+void DestroyBlockRenderer(BlockRenderer *renderer) {
+	if (renderer->mesh_program.program != NULL) {
+		DeleteShaderProgram(renderer->mesh_program.program);
+	}
+	if (renderer->pull_program.program != NULL) {
+		DeleteShaderProgram(renderer->pull_program.program);
+	}
+	if (renderer->instances != NULL) {
+		DestroyLeafBuffer(renderer->instances);
+	}
+	if (renderer->visible != NULL) {
+		DestroyVisibleRanges(renderer->visible);
+	}
+	if (renderer->indirect_ring != NULL) {
+		DestroyRingBuffer(renderer->indirect_ring);
+	}
+	ReleaseGPUMemory(GPU_OBJECT_BUFFER, renderer->instance_vbo);
+	ReleaseGPUMemory(GPU_OBJECT_BUFFER, renderer->mesh_ebo);
+	ReleaseGPUMemory(GPU_OBJECT_BUFFER, renderer->mesh_vbo);
+	glDeleteBuffers(1, &renderer->instance_vbo);
+	glDeleteBuffers(1, &renderer->mesh_ebo);
+	glDeleteBuffers(1, &renderer->mesh_vbo);
+	glDeleteVertexArrays(1, &renderer->pull_vao);
+	glDeleteVertexArrays(1, &renderer->vao);
+	TaggedFree(renderer);
+}
+
+void SetBlockRendererIFS(BlockRenderer *renderer, const IFS *ifs) {
+	if (ifs == renderer->ifs) {
+		return;
+	}
+
+	renderer->ifs = ifs;
+	renderer->depth = -1;
+	renderer->block_depth = -1;
+	if (renderer->instances != NULL) {
+		DestroyLeafBuffer(renderer->instances);
+		renderer->instances = NULL;
+	}
+}
+
+void SetBlockRendererMergeFaces(BlockRenderer *renderer, bool merge_faces) {
+	if (merge_faces != renderer->merge_faces) {
+		renderer->merge_faces = merge_faces;
+		renderer->block_depth = -1; // Rebake on the next SetBlockRendererDepth
+	}
+}
+
+void SetBlockRendererDepth(BlockRenderer *renderer, int depth,
+                           int block_depth) {
+	int max_depth = max_block_depth(renderer->ifs, depth);
+	if (block_depth > max_depth) {
+		block_depth = max_depth;
+	}
+	if (block_depth < 0) {
+		block_depth = 0;
+	}
+
+	if (block_depth != renderer->block_depth) {
+		TraceBegin("bake block");
+		Uint64 vertices;
+		PackedVertex *mesh = bake_block(renderer->ifs, block_depth,
+		                                renderer->merge_faces, &vertices);
+		bool uploaded = mesh != NULL && upload_block(renderer, mesh, vertices);
+		TraceEnd("bake block");
+		if (!uploaded) {
+			return;
+		}
+	}
+
+	int instance_depth = depth - block_depth;
+	if (renderer->instances == NULL ||
+	    renderer->instances->depth != instance_depth) {
+		LeafBuffer *instances =
+		    CreateIFSLeafBuffer(renderer->ifs, instance_depth);
+		if (instances == NULL) {
+			return;
+		}
+
+		glBindBuffer(GL_ARRAY_BUFFER, renderer->instance_vbo);
+		glBufferData(GL_ARRAY_BUFFER, sizeof(Leaf) * instances->count,
+		             instances->leaves, GL_STATIC_DRAW);
+		TrackGPUMemory(MEMORY_LEAVES, GPU_OBJECT_BUFFER,
+		               renderer->instance_vbo, sizeof(Leaf) * instances->count);
+
+		if (renderer->instances != NULL) {
+			DestroyLeafBuffer(renderer->instances);
+		}
+		renderer->instances = instances;
+	}
+
+	renderer->depth = depth;
+	renderer->block_depth = block_depth;
+}
+
+void DrawBlocks(BlockRenderer *renderer, mat4 view, mat4 perspective) {
+	bool pull = renderer->pull && BlockRendererCanPull(renderer);
+	BlockProgram *program =
+	    pull ? &renderer->pull_program : &renderer->mesh_program;
+	if (program->program == NULL || renderer->instances == NULL) {
+		return;
+	}
+
+	UseShaderProgram(program->program);
+	glUniformMatrix4fv(program->view_uniform, 1, GL_FALSE, (float *)view);
+	glUniformMatrix4fv(program->perspective_uniform, 1, GL_FALSE,
+	                   (float *)perspective);
+	glUniform1i(program->block_depth_uniform, renderer->block_depth);
+
+	glBindVertexArray(pull ? renderer->pull_vao : renderer->vao);
+	Uint64 count = draw_count(renderer, pull);
+
+	if ((!renderer->cull && !renderer->front_to_back) ||
+	    renderer->visible == NULL) {
+		draw_instanced(count, pull, (Uint32)renderer->instances->count);
+		renderer->draw_commands = 1;
+		renderer->draw_calls = 1;
+		renderer->instances_drawn = renderer->instances->count;
+		return;
+	}
+
+	mat4 view_proj;
+	glm_mat4_mul(perspective, view, view_proj);
+
+	// The camera position, from the inverse of the rigid view matrix
+	float eye[3];
+	for (int i = 0; i < 3; i++) {
+		eye[i] = -(view[i][0] * view[3][0] + view[i][1] * view[3][1] +
+		           view[i][2] * view[3][2]);
+	}
+
+	TraceBegin("cull");
+	CullLeafRanges(renderer->visible, renderer->ifs,
+	               renderer->cull ? view_proj : NULL,
+	               renderer->front_to_back ? eye : NULL,
+	               renderer->instances->depth, CULL_DEFAULT_MAX_LEVEL);
+	TraceEnd("cull");
+
+	VisibleRanges *visible = renderer->visible;
+	renderer->draw_commands = visible->count;
+	renderer->draw_calls = 0;
+	renderer->instances_drawn = visible->leaves;
+	if (visible->count == 0) {
+		return;
+	}
+
+	if (renderer->indirect_ring == NULL ||
+	    !draw_indirect(renderer, count, pull)) {
+		draw_ranges(renderer, count, pull);
+	}
+}
+
+// Average GPU time of one frame of DrawBlocks, in milliseconds.
+static double time_blocks(BlockRenderer *renderer, mat4 view,
+                          mat4 perspective) {
+	// Warm up once so uploads and shader compilation aren't timed.
+	DrawBlocks(renderer, view, perspective);
+	glFinish();
+
+	Uint64 start = SDL_GetTicksNS();
+	for (int i = 0; i < BENCHMARK_FRAMES; i++) {
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+		DrawBlocks(renderer, view, perspective);
+	}
+	glFinish();
+	Uint64 elapsed = SDL_GetTicksNS() - start;
+
+	return (double)elapsed / 1e6 / BENCHMARK_FRAMES;
+}
+
+void BenchmarkBlocks(BlockRenderer *renderer, mat4 view, mat4 perspective) {
+	int depth = renderer->depth;
+	int previous_block_depth = renderer->block_depth;
+	bool previous_pull = renderer->pull;
+
+	int max_depth = max_block_depth(renderer->ifs, depth);
+
+	printf("Block benchmark of the %s at depth %d (%d frames each)\n",
+	       renderer->ifs->name, depth, BENCHMARK_FRAMES);
+	printf("%5s %12s %12s %14s %16s %16s %10s %10s\n", "k", "instances",
+	       "mesh bytes", "instance bytes", "fetch/frame f32",
+	       "fetch/frame packed", "vbo ms", "pulled ms");
+
+	for (int k = 0; k <= max_depth; k++) {
+		SetBlockRendererDepth(renderer, depth, k);
+
+		renderer->pull = false;
+		double mesh_ms = time_blocks(renderer, view, perspective);
+		renderer->pull = true;
+		double pull_ms = BlockRendererCanPull(renderer)
+		                     ? time_blocks(renderer, view, perspective)
+		                     : 0.0;
+
+		// Attribute bytes fetched per frame, with the old 24-byte float
+		// vertices and with packed ones, for the vertices the simulated
+		// post-transform cache misses.
+		Uint64 instances = renderer->instances->count;
+		Uint64 instance_bytes = instances * sizeof(Leaf);
+		Uint64 vertices = instances * renderer->mesh_cache.misses;
+
+		printf("%5d %12llu %12llu %14llu %16llu %16llu %10.3f %10.3f\n", k,
+		       (unsigned long long)instances,
+		       (unsigned long long)(renderer->mesh_vertices *
+		                                sizeof(PackedVertex) +
+		                            renderer->mesh_indices * sizeof(Uint32)),
+		       (unsigned long long)instance_bytes,
+		       (unsigned long long)(vertices * UNPACKED_VERTEX_SIZE +
+		                            instance_bytes),
+		       (unsigned long long)(vertices * sizeof(PackedVertex) +
+		                            instance_bytes),
+		       mesh_ms, pull_ms);
+	}
+
+	renderer->pull = previous_pull;
+	SetBlockRendererDepth(renderer, depth, previous_block_depth);
+}
+
+void BenchmarkFaceMerging(BlockRenderer *renderer, mat4 view,
+                          mat4 perspective) {
+	int depth = renderer->depth;
+	int previous_block_depth = renderer->block_depth;
+	bool previous_merge = renderer->merge_faces;
+	bool previous_pull = renderer->pull;
+	renderer->pull = false;
+
+	int max_depth = max_block_depth(renderer->ifs, depth);
+
+	printf("Face merging benchmark of the %s at depth %d (%d frames each)\n",
+	       renderer->ifs->name, depth, BENCHMARK_FRAMES);
+	printf("%5s %14s %14s %10s %10s %10s\n", "k", "triangles", "merged",
+	       "saved", "ms", "merged ms");
+
+	for (int k = 0; k <= max_depth; k++) {
+		Uint64 triangles[2];
+		double ms[2];
+		for (int merge = 0; merge < 2; merge++) {
+			SetBlockRendererMergeFaces(renderer, merge == 1);
+			SetBlockRendererDepth(renderer, depth, k);
+			triangles[merge] = renderer->mesh_indices / 3;
+			ms[merge] = time_blocks(renderer, view, perspective);
+		}
+
+		printf("%5d %14llu %14llu %9.1f%% %10.3f %10.3f\n", k,
+		       (unsigned long long)triangles[0],
+		       (unsigned long long)triangles[1],
+		       100.0 * (double)(triangles[0] - triangles[1]) /
+		           (double)triangles[0],
+		       ms[0], ms[1]);
+	}
+
+	renderer->pull = previous_pull;
+	SetBlockRendererMergeFaces(renderer, previous_merge);
+	SetBlockRendererDepth(renderer, depth, previous_block_depth);
+}
+
+void BenchmarkVertexCache(BlockRenderer *renderer, mat4 view,
+                          mat4 perspective) {
+	int depth = renderer->depth;
+	int previous_block_depth = renderer->block_depth;
+	bool previous_optimize = renderer->optimize_vertex_cache;
+	bool previous_pull = renderer->pull;
+	renderer->pull = false;
+
+	int max_depth = max_block_depth(renderer->ifs, depth);
+
+	printf("Vertex cache benchmark of the %s at depth %d (FIFO cache of %d, "
+	       "%d frames each)\n",
+	       renderer->ifs->name, depth, renderer->vcache_size,
+	       BENCHMARK_FRAMES);
+	printf("%5s %10s %10s %8s %8s %8s %8s %10s %10s\n", "k", "triangles",
+	       "vertices", "ACMR", "ATVR", "opt ACMR", "opt ATVR", "ms",
+	       "opt ms");
+
+	for (int k = 0; k <= max_depth; k++) {
+		VertexCacheStats stats[2];
+		double ms[2];
+		for (int optimize = 0; optimize < 2; optimize++) {
+			renderer->optimize_vertex_cache = optimize == 1;
+			renderer->block_depth = -1; // Rebake
+			SetBlockRendererDepth(renderer, depth, k);
+			stats[optimize] = renderer->mesh_cache;
+			ms[optimize] = time_blocks(renderer, view, perspective);
+		}
+
+		printf("%5d %10llu %10llu %8.3f %8.3f %8.3f %8.3f %10.3f %10.3f\n",
+		       k, (unsigned long long)(renderer->mesh_indices / 3),
+		       (unsigned long long)renderer->mesh_vertices, stats[0].acmr,
+		       stats[0].atvr, stats[1].acmr, stats[1].atvr, ms[0], ms[1]);
+	}
+
+	renderer->pull = previous_pull;
+	renderer->optimize_vertex_cache = previous_optimize;
+	renderer->block_depth = -1;
+	SetBlockRendererDepth(renderer, depth, previous_block_depth);
+}
+
+void BenchmarkDrawOrder(BlockRenderer *renderer, mat4 view,
+                        mat4 perspective) {
+	bool previous_front_to_back = renderer->front_to_back;
+
+	FragmentCounter *counter = CreateFragmentCounter();
+	if (counter == NULL) {
+		return;
+	}
+
+	printf("Draw order benchmark at depth %d, k = %d (%d frames each)\n",
+	       renderer->depth, renderer->block_depth, BENCHMARK_FRAMES);
+	printf("%14s %10s %28s %10s\n", "order", "commands", counter->name,
+	       "ms/frame");
+
+	for (int i = 0; i < 2; i++) {
+		renderer->front_to_back = i == 1;
+
+		double ms = time_blocks(renderer, view, perspective);
+
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+		BeginFragmentCount(counter);
+		DrawBlocks(renderer, view, perspective);
+		Uint64 fragments = EndFragmentCount(counter);
+
+		printf("%14s %10u %28llu %10.3f\n",
+		       renderer->front_to_back ? "front-to-back" : "fixed",
+		       renderer->draw_commands, (unsigned long long)fragments, ms);
+	}
+
+	DestroyFragmentCounter(counter);
+	renderer->front_to_back = previous_front_to_back;
+}
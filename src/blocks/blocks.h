@@ -0,0 +1,191 @@
+#ifndef BLOCKS_H
+#define BLOCKS_H
+
+#include <cglm/cglm.h>
+
+#include "cull/cull.h"
+#include "glext/glext.h"
+#include "ifs/ifs.h"
+#include "leaves/leaves.h"
+#include "ring/ring.h"
+#include "shaders/shader.h"
+#include "vcache/vcache.h"
+
+// Deepest block that can be baked for the pyramid, 5^6 pyramids (~280k
+// vertices).
+#define BLOCK_MAX_DEPTH 6
+
+// Largest baked mesh, which limits the block depth of the other IFSs.
+#define BLOCK_MAX_VERTICES (18 * 15625)
+
+// Most vertices an IFS's base primitive may have.
+#define BLOCK_MAX_BASE_VERTICES 36
+
+// A shader program used to draw blocks and its uniforms
+typedef struct BlockProgram {
+	ShaderProgram *program;
+	int view_uniform;
+	int perspective_uniform;
+	int block_depth_uniform;
+} BlockProgram;
+
+/**
+ * Two-level hierarchical instancing.
+ *
+ * The fractal is self-similar, so depth `n` is the depth `k` mesh drawn at
+ * every leaf of depth `n - k`. A block of 5^k pyramids is baked into one VBO
+ * and instanced over the 5^(n-k) leaf transforms, which shrinks the instance
+ * buffer by 5^k at the cost of more vertex work per instance. A block depth
+ * of 0 is plain per-pyramid instancing.
+ *
+ * Any IFS from ifs.h can be drawn the same way, with N^k of its base
+ * primitives in the block for N maps.
+ *
+ * The baked mesh is indexed: identical vertices are welded and the triangles
+ * reordered for the post-transform vertex cache (see vcache.h).
+ */
+typedef struct BlockRenderer {
+	const IFS *ifs;  // The fractal drawn, the pyramid by default
+	int depth;       // Total subdivision depth `n`
+	int block_depth; // Depth `k` baked into the mesh (clamped to `n`)
+
+	unsigned int vao;
+	unsigned int mesh_vbo;
+	unsigned int mesh_ebo;
+	unsigned int instance_vbo;
+
+	Uint64 mesh_vertices; // Distinct vertices in `mesh_vbo`
+	Uint64 mesh_indices;  // Base primitive vertices * N^k, fewer if merged
+	LeafBuffer *instances; // Leaves at depth n - k
+
+	// Whether coplanar faces of the same color are merged when baking, see
+	// MergeCoplanarFaces
+	bool merge_faces;
+
+	// Whether the mesh's index order is optimized for a post-transform cache
+	// of `vcache_size` vertices, and how that cache would behave with it
+	bool optimize_vertex_cache;
+	int vcache_size;
+	VertexCacheStats mesh_cache;
+
+	// Reads the baked mesh from `mesh_vbo`
+	BlockProgram mesh_program;
+
+	/**
+	 * Vertex pulling: when `pull` is set the pyramid vertices and colors are
+	 * computed from gl_VertexID out of constant tables in pull.vert, and
+	 * `pull_vao` only has the instance attribute. Only the pyramid can be
+	 * pulled, other IFSs always read the mesh.
+	 */
+	bool pull;
+	BlockProgram pull_program;
+	unsigned int pull_vao;
+
+	/**
+	 * When set, instances are culled against the view frustum and only the
+	 * visible ranges are drawn. With multi-draw indirect every range becomes
+	 * one DrawArraysIndirectCommand (its first instance as `base_instance`)
+	 * and all of them go out in one call, without compacting the instance
+	 * buffer. Otherwise each range is a separate instanced draw.
+	 *
+	 * The commands are streamed through a persistently mapped ring buffer.
+	 */
+	bool cull;
+
+	/**
+	 * When set, instances are drawn roughly front to back so the depth test
+	 * can reject hidden fragments early. The range traversal visits
+	 * children in camera-octant order and the ranges are drawn in the order
+	 * visited. The instance buffer itself keeps its fixed order.
+	 */
+	bool front_to_back;
+
+	VisibleRanges *visible; // Allocated from the frame arena
+	RingBuffer *indirect_ring;
+
+	// Statistics for the last DrawBlocks call
+	Uint32 draw_commands;   // Indirect commands (or draw calls) issued
+	Uint32 draw_calls;      // GL draw calls they took
+	Uint64 instances_drawn; // Instances covered by those commands
+} BlockRenderer;
+
+/**
+ * Create a block renderer with nothing baked yet. The visible ranges are
+ * allocated every frame from `frame_arena`.
+ */
+BlockRenderer *CreateBlockRenderer(Arena *frame_arena);
+
+// Free the block renderer and its GL objects.
+void DestroyBlockRenderer(BlockRenderer *renderer);
+
+/**
+ * Switch to drawing `ifs`. The mesh and instances are rebuilt by the next
+ * SetBlockRendererDepth.
+ */
+void SetBlockRendererIFS(BlockRenderer *renderer, const IFS *ifs);
+
+/**
+ * Turn merging coplanar faces in the baked mesh on or off (on by default).
+ * The mesh is rebaked by the next SetBlockRendererDepth.
+ */
+void SetBlockRendererMergeFaces(BlockRenderer *renderer, bool merge_faces);
+
+/**
+ * Bake the depth `block_depth` mesh and upload the instances for a total
+ * depth of `depth`. `block_depth` is clamped to [0, `depth`] and to the
+ * deepest block of at most BLOCK_MAX_VERTICES vertices (BLOCK_MAX_DEPTH for
+ * the pyramid).
+ *
+ * Does nothing if neither value changed since the last call.
+ */
+void SetBlockRendererDepth(BlockRenderer *renderer, int depth,
+                           int block_depth);
+
+/**
+ * Whether `renderer->pull` is honored: pull.vert only knows the pyramid, and
+ * has to have compiled. Otherwise the mesh is drawn instead.
+ */
+bool BlockRendererCanPull(const BlockRenderer *renderer);
+
+// Draw the instances, culled if `renderer->cull` is set and ordered if
+// `renderer->front_to_back` is.
+void DrawBlocks(BlockRenderer *renderer, mat4 view, mat4 perspective);
+
+/**
+ * Time every block depth from 0 up to the deepest that can be baked at the
+ * current camera and print the vertex count, instance bytes and GPU frame
+ * time of each, to show the trade-off between vertex work and instance fetch.
+ * Every depth is timed with both the mesh VBO and vertex pulling (shown as
+ * 0 for IFSs that can't be pulled).
+ *
+ * The renderer is restored to its previous block depth afterwards.
+ */
+void BenchmarkBlocks(BlockRenderer *renderer, mat4 view, mat4 perspective);
+
+/**
+ * Time every block depth with and without merged faces and print the
+ * triangle count and GPU frame time of each. Vertex pulling is off while
+ * timing, it always draws the unmerged primitives.
+ *
+ * The renderer is restored to its previous settings afterwards.
+ */
+void BenchmarkFaceMerging(BlockRenderer *renderer, mat4 view,
+                          mat4 perspective);
+
+/**
+ * Time every block depth with the welded index order and the one optimized
+ * for the vertex cache, and print the simulated ACMR and ATVR and the GPU
+ * frame time of each. Vertex pulling is off while timing, it isn't indexed.
+ *
+ * The renderer is restored to its previous settings afterwards.
+ */
+void BenchmarkVertexCache(BlockRenderer *renderer, mat4 view,
+                          mat4 perspective);
+
+/**
+ * Time the current depth with the fixed and the front-to-back draw orders
+ * and print the frame time and fragment count of each.
+ */
+void BenchmarkDrawOrder(BlockRenderer *renderer, mat4 view, mat4 perspective);
+
+#endif // BLOCKS_H
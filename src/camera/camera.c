@@ -3,12 +3,14 @@
 #include <stdlib.h>
 #include <math.h>
 
+#include "memory/memory.h"
+
 const float camera_speed = 0.025f;
 
 const float camera_sensitivity = 0.1f;
 
 Camera *CreateCamera(vec3 position, vec3 target, vec3 up) {
-	Camera *camera = (Camera *)malloc(sizeof(Camera));
+	Camera *camera = (Camera *)TaggedMalloc(MEMORY_APP, sizeof(Camera));
 	if (camera == NULL) {
 		perror("Could not allocate memory for camera");
 		return NULL;
@@ -33,7 +35,7 @@ Camera *CreateCamera(vec3 position, vec3 target, vec3 up) {
 	return camera;
 }
 
-void DestroyCamera(Camera *camera) { free(camera); }
+void DestroyCamera(Camera *camera) { TaggedFree(camera); }
 
 void MoveCamera(Camera *camera, vec3 direction) {
 	vec3 temp; // Temporary variable for vector calculations
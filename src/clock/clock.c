@@ -2,8 +2,10 @@
 
 #include <stdlib.h>
 
+#include "memory/memory.h"
+
 Clock *CreateClock(int fps) {
-    Clock *clock = (Clock *)malloc(sizeof(Clock));
+    Clock *clock = (Clock *)TaggedMalloc(MEMORY_APP, sizeof(Clock));
 
     clock->current_frame = 0;
     clock->last_frame = 0;
@@ -14,7 +16,7 @@ Clock *CreateClock(int fps) {
 }
 
 void DestroyClock(Clock *clock) {
-    free(clock);
+    TaggedFree(clock);
 }
 
 void TickClock(Clock *clock) {
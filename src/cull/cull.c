@@ -0,0 +1,322 @@
+#include "cull/cull.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "memory/memory.h"
+#include "perf/perf.h"
+
+#define ALL_PLANES 0x3f
+
+// Children in map order, for when there is no eye to sort them by
+static const int fixed_order[IFS_MAX_MAPS] = {
+    0,  1,  2,  3,  4,  5,  6,  7,  8,  9,  10, 11, 12, 13,
+    14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26};
+
+// Culling passes timed per layout by BenchmarkLeafLayouts
+#define BENCHMARK_PASSES 10
+
+typedef struct CullState {
+	const IFS *ifs;
+	VisibleRanges *visible;
+	vec4 planes[6];
+	const float *eye; // Visit children front to back from here, if set
+	int depth;
+	int max_level;
+	Uint64 leaf_counts[32]; // maps^(depth - level), indexed by level
+} CullState;
+
+/**
+ * Double the capacity of `visible`. If its arena is full, the ranges move to
+ * the heap for good rather than drop geometry. Returns false if the heap is
+ * out of memory too.
+ */
+static bool grow_ranges(VisibleRanges *visible) {
+	Uint32 capacity = visible->capacity ? visible->capacity * 2 : 256;
+	DrawRange *ranges;
+	if (visible->arena != NULL) {
+		ranges = (DrawRange *)ArenaResize(
+		    visible->arena, visible->ranges,
+		    sizeof(DrawRange) * visible->capacity,
+		    sizeof(DrawRange) * capacity, sizeof(Uint32));
+		if (ranges == NULL) {
+			printf("Arena %s is full, keeping visible ranges on the heap\n",
+			       visible->arena->name);
+			ranges = (DrawRange *)TaggedMalloc(MEMORY_CULLING,
+			                                   sizeof(DrawRange) * capacity);
+			if (ranges == NULL) {
+				return false;
+			}
+			memcpy(ranges, visible->ranges,
+			       sizeof(DrawRange) * visible->count);
+			visible->arena = NULL;
+		}
+	} else {
+		ranges = (DrawRange *)TaggedRealloc(MEMORY_CULLING, visible->ranges,
+		                                    sizeof(DrawRange) * capacity);
+		if (ranges == NULL) {
+			return false;
+		}
+	}
+	visible->ranges = ranges;
+	visible->capacity = capacity;
+	return true;
+}
+
+// Append a range, merging it with the previous one when they touch.
+static void emit_range(VisibleRanges *visible, Uint32 first, Uint32 count) {
+	visible->leaves += count;
+
+	if (visible->count > 0) {
+		DrawRange *last = &visible->ranges[visible->count - 1];
+		if (last->first + last->count == first) {
+			last->count += count;
+			return;
+		}
+	}
+
+	if (visible->count == visible->capacity && !grow_ranges(visible)) {
+		if (!visible->truncated) {
+			perror("Could not allocate memory for visible ranges");
+			visible->truncated = true;
+		}
+		// Stretch the last range over this one, drawing the leaves in
+		// between too, rather than let geometry disappear
+		if (visible->count > 0) {
+			DrawRange *last = &visible->ranges[visible->count - 1];
+			Uint32 end = last->first + last->count;
+			if (first + count > end) {
+				end = first + count;
+			}
+			if (first < last->first) {
+				last->first = first;
+			}
+			last->count = end - last->first;
+		}
+		return;
+	}
+
+	visible->ranges[visible->count++] = (DrawRange){first, count};
+}
+
+/**
+ * Test a subtree's bounding box (its pyramid's, `center` +- `scale` / 2)
+ * against the planes left in `mask`. Planes the box is fully inside of are
+ * dropped from the mask for the children.
+ */
+static void cull_node(CullState *state, const float center[3], float scale,
+                      int level, Uint64 index, int mask) {
+	state->visible->nodes_tested++;
+
+	float extent = 0.5f * scale;
+	for (int p = 0; p < 6; p++) {
+		if (!(mask & (1 << p))) {
+			continue;
+		}
+
+		const float *plane = state->planes[p];
+		float distance = plane[0] * center[0] + plane[1] * center[1] +
+		                 plane[2] * center[2] + plane[3];
+		float radius = extent * (fabsf(plane[0]) + fabsf(plane[1]) +
+		                         fabsf(plane[2]));
+		if (distance < -radius) {
+			return; // Fully outside
+		}
+		if (distance >= radius) {
+			mask &= ~(1 << p); // Fully inside this plane
+		}
+	}
+
+	// Subtrees fully inside are kept whole, unless they still need to be
+	// split up to be ordered.
+	Uint64 leaves = state->leaf_counts[level];
+	if ((mask == 0 && state->eye == NULL) || level >= state->max_level) {
+		emit_range(state->visible, (Uint32)(index * leaves), (Uint32)leaves);
+		return;
+	}
+
+	const IFS *ifs = state->ifs;
+	int scratch[IFS_MAX_MAPS];
+	const int *order =
+	    state->eye != NULL
+	        ? IFSChildOrder(ifs, center, scale, state->eye, scratch)
+	        : fixed_order;
+
+	float child_scale = ifs->ratio * scale;
+	for (int i = 0; i < ifs->map_count; i++) {
+		int c = order[i];
+		float child[3] = {center[0] + ifs->offsets[c][0] * child_scale,
+		                  center[1] + ifs->offsets[c][1] * child_scale,
+		                  center[2] + ifs->offsets[c][2] * child_scale};
+		cull_node(state, child, child_scale, level + 1,
+		          index * ifs->map_count + c, mask);
+	}
+}
+
+/**
+ * Empty the list before culling into it.
+ *
+ * Ranges in an arena are gone once it has been reset. Within a frame the
+ * previous array is grown in place if nothing was allocated after it, so
+ * culling several times per frame doesn't use up the arena.
+ */
+static void clear_ranges(VisibleRanges *visible) {
+	visible->count = 0;
+	visible->leaves = 0;
+	visible->truncated = false;
+
+	Arena *arena = visible->arena;
+	if (arena != NULL &&
+	    (visible->arena_resets != arena->resets ||
+	     !ArenaIsLast(arena, visible->ranges,
+	                  sizeof(DrawRange) * visible->capacity))) {
+		visible->ranges = NULL;
+		visible->capacity = 0;
+		visible->arena_resets = arena->resets;
+	}
+}
+
+VisibleRanges *CreateVisibleRanges(Arena *arena) {
+	VisibleRanges *visible =
+	    (VisibleRanges *)TaggedCalloc(MEMORY_CULLING, 1, sizeof(VisibleRanges));
+	if (visible == NULL) {
+		perror("Could not allocate memory for visible ranges");
+		return NULL;
+	}
+	visible->arena = arena;
+	return visible;
+}
+
+void DestroyVisibleRanges(VisibleRanges *visible) {
+	if (visible->arena == NULL) {
+		TaggedFree(visible->ranges);
+	}
+	TaggedFree(visible);
+}
+
+void CullLeafRanges(VisibleRanges *visible, const IFS *ifs, mat4 view_proj,
+                    const float *eye, int depth, int max_level) {
+	// IFSs with more maps than the pyramid stop higher up, to test no more
+	// nodes than it would.
+	Uint64 max_nodes = LeafCount(max_level);
+	while (max_level > 0 && IFSLeafCount(ifs, max_level) > max_nodes) {
+		max_level--;
+	}
+
+	CullState state;
+	state.ifs = ifs;
+	state.visible = visible;
+	state.eye = eye;
+	state.depth = depth;
+	state.max_level = max_level < depth ? max_level : depth;
+	if (view_proj != NULL) {
+		glm_frustum_planes(view_proj, state.planes);
+	}
+
+	for (int level = depth; level >= 0; level--) {
+		state.leaf_counts[level] = IFSLeafCount(ifs, depth - level);
+	}
+
+	clear_ranges(visible);
+	visible->nodes_tested = 0;
+
+	const float root[3] = {0.0f, 0.0f, 0.0f};
+	cull_node(&state, root, 1.0f, 0, 0, view_proj != NULL ? ALL_PLANES : 0);
+}
+
+void CullLeaves(VisibleRanges *visible, const LeafBuffer *buffer,
+                mat4 view_proj) {
+	vec4 planes[6];
+	glm_frustum_planes(view_proj, planes);
+
+	clear_ranges(visible);
+	visible->nodes_tested = buffer->count;
+
+	for (Uint64 i = 0; i < buffer->count; i++) {
+		const Leaf *leaf = &buffer->leaves[i];
+		float extent = 0.5f * leaf->scale;
+
+		bool inside = true;
+		for (int p = 0; p < 6 && inside; p++) {
+			const float *plane = planes[p];
+			float distance = plane[0] * leaf->center[0] +
+			                 plane[1] * leaf->center[1] +
+			                 plane[2] * leaf->center[2] + plane[3];
+			float radius = extent * (fabsf(plane[0]) + fabsf(plane[1]) +
+			                         fabsf(plane[2]));
+			inside = distance >= -radius;
+		}
+
+		if (inside) {
+			emit_range(visible, (Uint32)i, 1);
+		}
+	}
+}
+
+// Time CullLeaves over each layout and print one row per layout.
+static void benchmark_layouts(LeafBuffer *buffers[2], VisibleRanges *visible,
+                              PerfCounters *counters, mat4 view_proj) {
+	printf("%10s %14s %10s %10s %14s %14s\n", "layout", "Mleaves/s",
+	       "visible", "runs", "cache refs", "cache misses");
+
+	for (int b = 0; b < 2; b++) {
+		// Warm up, then time
+		CullLeaves(visible, buffers[b], view_proj);
+
+		StartPerfCounters(counters);
+		Uint64 start = SDL_GetTicksNS();
+		for (int i = 0; i < BENCHMARK_PASSES; i++) {
+			CullLeaves(visible, buffers[b], view_proj);
+		}
+		Uint64 elapsed = SDL_GetTicksNS() - start;
+		StopPerfCounters(counters);
+
+		double leaves_per_second = (double)buffers[b]->count *
+		                           BENCHMARK_PASSES / ((double)elapsed / 1e9);
+
+		printf("%10s %14.2f %10llu %10u", b == 0 ? "traversal" : "morton",
+		       leaves_per_second / 1e6, (unsigned long long)visible->leaves,
+		       visible->count);
+		if (counters->available) {
+			printf(" %14llu %14llu\n",
+			       (unsigned long long)counters->references /
+			           BENCHMARK_PASSES,
+			       (unsigned long long)counters->misses / BENCHMARK_PASSES);
+		} else {
+			printf(" %14s %14s\n", "n/a", "n/a");
+		}
+	}
+}
+
+void BenchmarkLeafLayouts(int depth, mat4 view_proj) {
+	LeafBuffer *buffers[2] = {CreateLeafBuffer(depth),
+	                          CreateLeafBuffer(depth)};
+	VisibleRanges *visible = CreateVisibleRanges(NULL);
+	PerfCounters *counters = CreatePerfCounters();
+
+	if (buffers[0] != NULL && buffers[1] != NULL && visible != NULL &&
+	    counters != NULL) {
+		Uint64 sort_start = SDL_GetTicksNS();
+		SortLeavesMorton(buffers[1]);
+		Uint64 sort_ns = SDL_GetTicksNS() - sort_start;
+
+		printf("Leaf layout benchmark at depth %d (%llu leaves, %d passes, "
+		       "Morton sort took %.2f ms)\n",
+		       depth, (unsigned long long)buffers[0]->count,
+		       BENCHMARK_PASSES, (double)sort_ns / 1e6);
+		benchmark_layouts(buffers, visible, counters, view_proj);
+	}
+
+	if (counters != NULL) {
+		DestroyPerfCounters(counters);
+	}
+	if (visible != NULL) {
+		DestroyVisibleRanges(visible);
+	}
+	for (int b = 0; b < 2; b++) {
+		if (buffers[b] != NULL) {
+			DestroyLeafBuffer(buffers[b]);
+		}
+	}
+}
@@ -0,0 +1,89 @@
+#ifndef CULL_H
+#define CULL_H
+
+#include <SDL3/SDL.h>
+#include <cglm/cglm.h>
+
+#include "arena/arena.h"
+#include "ifs/ifs.h"
+#include "leaves/leaves.h"
+
+// Default deepest level tested by CullLeafRanges. Nodes that still straddle
+// the frustum at this level are kept whole, which bounds the culling cost to
+// at most 5^6 node tests regardless of the depth (or the IFS, see
+// CullLeafRanges).
+#define CULL_DEFAULT_MAX_LEVEL 6
+
+// A run of consecutive leaves, in traversal order.
+typedef struct DrawRange {
+	Uint32 first;
+	Uint32 count;
+} DrawRange;
+
+/**
+ * The result of culling the leaf tree against the view frustum.
+ *
+ * Because leaves are stored in traversal order (see leaves.h), each
+ * visible subtree is one contiguous range, and adjacent visible subtrees are
+ * merged into a single range. The array grows as needed. It is either kept
+ * on the heap and reused from frame to frame, or allocated from an arena
+ * (normally the frame arena) and only valid until that is reset. If the
+ * arena runs out, the array moves to the heap.
+ */
+typedef struct VisibleRanges {
+	DrawRange *ranges;
+	Uint32 count;
+	Uint32 capacity;
+
+	Arena *arena;        // Where `ranges` lives, heap if NULL
+	Uint64 arena_resets; // `arena->resets` when `ranges` was allocated
+
+	Uint64 leaves;       // Total leaves covered by `ranges`
+	Uint64 nodes_tested; // Subtrees tested against the frustum
+	bool truncated;      // Out of memory, the last range covers the rest
+} VisibleRanges;
+
+// Create an empty range list, allocating from `arena` if it isn't NULL.
+VisibleRanges *CreateVisibleRanges(Arena *arena);
+
+// Free a range list.
+void DestroyVisibleRanges(VisibleRanges *visible);
+
+/**
+ * Cull the leaves of a `depth` deep `ifs` against the frustum of
+ * `view_proj` and store the visible ranges in `visible`.
+ *
+ * Subtrees entirely inside the frustum are emitted without visiting their
+ * children. Subtrees still intersecting the frustum at `max_level` are
+ * emitted whole. For IFSs with more than 5 maps `max_level` is lowered so
+ * no more than 5^`max_level` nodes can be reached.
+ *
+ * If `eye` is set, children are visited front to back from it (see
+ * IFSChildOrder) and subtrees are split down to `max_level` so the ranges
+ * come out roughly sorted near to far, for early depth rejection. If
+ * `view_proj` is NULL nothing is culled, which only makes sense to order.
+ */
+void CullLeafRanges(VisibleRanges *visible, const IFS *ifs, mat4 view_proj,
+                    const float *eye, int depth, int max_level);
+
+/**
+ * Test every leaf of `buffer` against the frustum of `view_proj` and store
+ * runs of consecutive visible leaves in `visible`.
+ *
+ * Unlike CullLeafRanges this reads the leaf records themselves, so it works
+ * with any layout and its speed depends on how the leaves sit in memory.
+ */
+void CullLeaves(VisibleRanges *visible, const LeafBuffer *buffer,
+                mat4 view_proj);
+
+// Deepest level BenchmarkLeafLayouts is run at from the app (5^10 leaves).
+#define LEAF_BENCHMARK_MAX_DEPTH 10
+
+/**
+ * Compare flat culling over the traversal-ordered and Morton-ordered leaf
+ * layouts at `depth`: prints throughput, visible runs (the granularity of a
+ * partial upload) and, where perf counters are available, cache misses.
+ */
+void BenchmarkLeafLayouts(int depth, mat4 view_proj);
+
+#endif // CULL_H
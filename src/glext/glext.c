@@ -0,0 +1,70 @@
+#include "glext/glext.h"
+
+#include <SDL3/SDL.h>
+
+PFNGLMULTIDRAWARRAYSINDIRECTPROC glext_glMultiDrawArraysIndirect = NULL;
+PFNGLMULTIDRAWELEMENTSINDIRECTPROC glext_glMultiDrawElementsIndirect = NULL;
+PFNGLBUFFERSTORAGEPROC glext_glBufferStorage = NULL;
+PFNGLDEBUGMESSAGECALLBACKPROC glext_glDebugMessageCallback = NULL;
+PFNGLDEBUGMESSAGECONTROLPROC glext_glDebugMessageControl = NULL;
+
+GLExtensions gl_extensions;
+
+// Whether the context is at least version `major`.`minor`
+static bool has_version(int major, int minor) {
+	return gl_extensions.major > major ||
+	       (gl_extensions.major == major && gl_extensions.minor >= minor);
+}
+
+void LoadGLExtensions(void) {
+	glGetIntegerv(GL_MAJOR_VERSION, &gl_extensions.major);
+	glGetIntegerv(GL_MINOR_VERSION, &gl_extensions.minor);
+
+	if (has_version(4, 3) ||
+	    (SDL_GL_ExtensionSupported("GL_ARB_multi_draw_indirect") &&
+	     SDL_GL_ExtensionSupported("GL_ARB_base_instance"))) {
+		glext_glMultiDrawArraysIndirect =
+		    (PFNGLMULTIDRAWARRAYSINDIRECTPROC)SDL_GL_GetProcAddress(
+		        "glMultiDrawArraysIndirect");
+		glext_glMultiDrawElementsIndirect =
+		    (PFNGLMULTIDRAWELEMENTSINDIRECTPROC)SDL_GL_GetProcAddress(
+		        "glMultiDrawElementsIndirect");
+	}
+	gl_extensions.multi_draw_indirect =
+	    glext_glMultiDrawArraysIndirect != NULL &&
+	    glext_glMultiDrawElementsIndirect != NULL;
+
+	if (has_version(4, 4) ||
+	    SDL_GL_ExtensionSupported("GL_ARB_buffer_storage")) {
+		glext_glBufferStorage =
+		    (PFNGLBUFFERSTORAGEPROC)SDL_GL_GetProcAddress("glBufferStorage");
+	}
+	gl_extensions.buffer_storage = glext_glBufferStorage != NULL;
+
+	gl_extensions.pipeline_statistics =
+	    has_version(4, 6) ||
+	    SDL_GL_ExtensionSupported("GL_ARB_pipeline_statistics_query");
+
+	gl_extensions.timer_query =
+	    has_version(3, 3) || SDL_GL_ExtensionSupported("GL_ARB_timer_query");
+
+	if (has_version(4, 3) || SDL_GL_ExtensionSupported("GL_KHR_debug")) {
+		glext_glDebugMessageCallback =
+		    (PFNGLDEBUGMESSAGECALLBACKPROC)SDL_GL_GetProcAddress(
+		        "glDebugMessageCallback");
+		glext_glDebugMessageControl =
+		    (PFNGLDEBUGMESSAGECONTROLPROC)SDL_GL_GetProcAddress(
+		        "glDebugMessageControl");
+	}
+	gl_extensions.debug_output = glext_glDebugMessageCallback != NULL &&
+	                             glext_glDebugMessageControl != NULL;
+
+	printf("OpenGL %d.%d, multi-draw indirect: %s, buffer storage: %s, "
+	       "pipeline statistics: %s, timer queries: %s, debug output: %s\n",
+	       gl_extensions.major, gl_extensions.minor,
+	       gl_extensions.multi_draw_indirect ? "yes" : "no",
+	       gl_extensions.buffer_storage ? "yes" : "no",
+	       gl_extensions.pipeline_statistics ? "yes" : "no",
+	       gl_extensions.timer_query ? "yes" : "no",
+	       gl_extensions.debug_output ? "yes" : "no");
+}
@@ -0,0 +1,111 @@
+#ifndef GLEXT_H
+#define GLEXT_H
+
+#include <glad/glad.h>
+#include <stdbool.h>
+
+/**
+ * Entry points and enums newer than the GL 3.3 core profile glad was
+ * generated for. They are loaded by LoadGLExtensions when the context version
+ * or an extension provides them, and every caller must check the matching
+ * flag in `gl_extensions` first, since the WebGL and 3.3 fallbacks lack them.
+ */
+
+#define GL_DRAW_INDIRECT_BUFFER 0x8F3F
+
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#define GL_MAP_COHERENT_BIT 0x0080
+#define GL_DYNAMIC_STORAGE_BIT 0x0100
+#define GL_CLIENT_STORAGE_BIT 0x0200
+
+// ARB_pipeline_statistics_query query targets
+#define GL_VERTICES_SUBMITTED_ARB 0x82EE
+#define GL_PRIMITIVES_SUBMITTED_ARB 0x82EF
+#define GL_VERTEX_SHADER_INVOCATIONS_ARB 0x82F0
+#define GL_FRAGMENT_SHADER_INVOCATIONS_ARB 0x82F4
+#define GL_CLIPPING_INPUT_PRIMITIVES_ARB 0x82F6
+#define GL_CLIPPING_OUTPUT_PRIMITIVES_ARB 0x82F7
+
+// KHR_debug
+#define GL_DEBUG_OUTPUT 0x92E0
+#define GL_DEBUG_OUTPUT_SYNCHRONOUS 0x8242
+#define GL_DEBUG_TYPE_ERROR 0x824C
+#define GL_DEBUG_TYPE_PERFORMANCE 0x8250
+
+typedef struct DrawArraysIndirectCommand {
+	GLuint count;
+	GLuint instance_count;
+	GLuint first;
+	GLuint base_instance;
+} DrawArraysIndirectCommand;
+
+typedef struct DrawElementsIndirectCommand {
+	GLuint count;
+	GLuint instance_count;
+	GLuint first_index;
+	GLint base_vertex;
+	GLuint base_instance;
+} DrawElementsIndirectCommand;
+
+typedef void(APIENTRYP PFNGLMULTIDRAWARRAYSINDIRECTPROC)(
+    GLenum mode, const void *indirect, GLsizei drawcount, GLsizei stride);
+extern PFNGLMULTIDRAWARRAYSINDIRECTPROC glext_glMultiDrawArraysIndirect;
+#define glMultiDrawArraysIndirect glext_glMultiDrawArraysIndirect
+
+typedef void(APIENTRYP PFNGLMULTIDRAWELEMENTSINDIRECTPROC)(
+    GLenum mode, GLenum type, const void *indirect, GLsizei drawcount,
+    GLsizei stride);
+extern PFNGLMULTIDRAWELEMENTSINDIRECTPROC glext_glMultiDrawElementsIndirect;
+#define glMultiDrawElementsIndirect glext_glMultiDrawElementsIndirect
+
+typedef void(APIENTRYP PFNGLBUFFERSTORAGEPROC)(GLenum target, GLsizeiptr size,
+                                               const void *data,
+                                               GLbitfield flags);
+extern PFNGLBUFFERSTORAGEPROC glext_glBufferStorage;
+#define glBufferStorage glext_glBufferStorage
+
+typedef void(APIENTRYP PFNGLDEBUGMESSAGECALLBACKPROC)(GLDEBUGPROC callback,
+                                                      const void *userParam);
+extern PFNGLDEBUGMESSAGECALLBACKPROC glext_glDebugMessageCallback;
+#define glDebugMessageCallback glext_glDebugMessageCallback
+
+typedef void(APIENTRYP PFNGLDEBUGMESSAGECONTROLPROC)(GLenum source,
+                                                     GLenum type,
+                                                     GLenum severity,
+                                                     GLsizei count,
+                                                     const GLuint *ids,
+                                                     GLboolean enabled);
+extern PFNGLDEBUGMESSAGECONTROLPROC glext_glDebugMessageControl;
+#define glDebugMessageControl glext_glDebugMessageControl
+
+// Which of the optional features the current context supports
+typedef struct GLExtensions {
+	int major;
+	int minor;
+
+	// glMultiDrawArraysIndirect and glMultiDrawElementsIndirect with a
+	// non-zero `base_instance` (GL 4.3, or ARB_multi_draw_indirect +
+	// ARB_base_instance)
+	bool multi_draw_indirect;
+
+	// Immutable storage that can stay persistently mapped (GL 4.4, or
+	// ARB_buffer_storage)
+	bool buffer_storage;
+
+	// Pipeline statistics queries (GL 4.6, or ARB_pipeline_statistics_query)
+	bool pipeline_statistics;
+
+	// GL_TIME_ELAPSED and GL_TIMESTAMP queries (GL 3.3, or ARB_timer_query)
+	bool timer_query;
+
+	// Driver messages through glDebugMessageCallback (GL 4.3, or KHR_debug).
+	// Most drivers only send them to contexts created with the debug flag.
+	bool debug_output;
+} GLExtensions;
+
+extern GLExtensions gl_extensions;
+
+// Load the optional entry points. Must be called after gladLoadGLLoader.
+void LoadGLExtensions(void);
+
+#endif // GLEXT_H
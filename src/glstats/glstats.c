@@ -0,0 +1,477 @@
+#include "glstats/glstats.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "glext/glext.h"
+#include "trace/trace.h"
+
+/**
+ * The GL functions this program calls, as
+ * (name, pointer type, parameters, arguments). Functions that upload data
+ * are in GL_UPLOADING_FUNCTIONS instead, with the counter and size of what
+ * they upload.
+ */
+#define GL_VOID_FUNCTIONS(X)                                                   \
+	X(glActiveTexture, PFNGLACTIVETEXTUREPROC, (GLenum texture), (texture))    \
+	X(glAttachShader, PFNGLATTACHSHADERPROC, (GLuint program, GLuint shader),  \
+	  (program, shader))                                                       \
+	X(glBeginQuery, PFNGLBEGINQUERYPROC, (GLenum target, GLuint id),           \
+	  (target, id))                                                            \
+	X(glBindBuffer, PFNGLBINDBUFFERPROC, (GLenum target, GLuint buffer),       \
+	  (target, buffer))                                                        \
+	X(glBindFramebuffer, PFNGLBINDFRAMEBUFFERPROC,                             \
+	  (GLenum target, GLuint framebuffer), (target, framebuffer))              \
+	X(glBindRenderbuffer, PFNGLBINDRENDERBUFFERPROC,                           \
+	  (GLenum target, GLuint renderbuffer), (target, renderbuffer))            \
+	X(glBindTexture, PFNGLBINDTEXTUREPROC, (GLenum target, GLuint texture),    \
+	  (target, texture))                                                       \
+	X(glBindVertexArray, PFNGLBINDVERTEXARRAYPROC, (GLuint array), (array))    \
+	X(glBlendFunc, PFNGLBLENDFUNCPROC, (GLenum sfactor, GLenum dfactor),       \
+	  (sfactor, dfactor))                                                      \
+	X(glClear, PFNGLCLEARPROC, (GLbitfield mask), (mask))                      \
+	X(glClearColor, PFNGLCLEARCOLORPROC,                                       \
+	  (GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha),               \
+	  (red, green, blue, alpha))                                               \
+	X(glColorMask, PFNGLCOLORMASKPROC,                                         \
+	  (GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha),       \
+	  (red, green, blue, alpha))                                               \
+	X(glCompileShader, PFNGLCOMPILESHADERPROC, (GLuint shader), (shader))      \
+	X(glDeleteBuffers, PFNGLDELETEBUFFERSPROC,                                 \
+	  (GLsizei n, const GLuint *buffers), (n, buffers))                        \
+	X(glDeleteFramebuffers, PFNGLDELETEFRAMEBUFFERSPROC,                       \
+	  (GLsizei n, const GLuint *framebuffers), (n, framebuffers))              \
+	X(glDeleteProgram, PFNGLDELETEPROGRAMPROC, (GLuint program), (program))    \
+	X(glDeleteQueries, PFNGLDELETEQUERIESPROC, (GLsizei n, const GLuint *ids), \
+	  (n, ids))                                                                \
+	X(glDeleteRenderbuffers, PFNGLDELETERENDERBUFFERSPROC,                     \
+	  (GLsizei n, const GLuint *renderbuffers), (n, renderbuffers))            \
+	X(glDeleteShader, PFNGLDELETESHADERPROC, (GLuint shader), (shader))        \
+	X(glDeleteSync, PFNGLDELETESYNCPROC, (GLsync sync), (sync))                \
+	X(glDeleteTextures, PFNGLDELETETEXTURESPROC,                               \
+	  (GLsizei n, const GLuint *textures), (n, textures))                      \
+	X(glDeleteVertexArrays, PFNGLDELETEVERTEXARRAYSPROC,                       \
+	  (GLsizei n, const GLuint *arrays), (n, arrays))                          \
+	X(glDisable, PFNGLDISABLEPROC, (GLenum cap), (cap))                        \
+	X(glDrawArrays, PFNGLDRAWARRAYSPROC,                                       \
+	  (GLenum mode, GLint first, GLsizei count), (mode, first, count))         \
+	X(glDrawArraysInstanced, PFNGLDRAWARRAYSINSTANCEDPROC,                     \
+	  (GLenum mode, GLint first, GLsizei count, GLsizei instancecount),        \
+	  (mode, first, count, instancecount))                                     \
+	X(glDrawElements, PFNGLDRAWELEMENTSPROC,                                   \
+	  (GLenum mode, GLsizei count, GLenum type, const void *indices),          \
+	  (mode, count, type, indices))                                            \
+	X(glDrawElementsInstanced, PFNGLDRAWELEMENTSINSTANCEDPROC,                 \
+	  (GLenum mode, GLsizei count, GLenum type, const void *indices,           \
+	   GLsizei instancecount),                                                 \
+	  (mode, count, type, indices, instancecount))                             \
+	X(glEnable, PFNGLENABLEPROC, (GLenum cap), (cap))                          \
+	X(glEnableVertexAttribArray, PFNGLENABLEVERTEXATTRIBARRAYPROC,             \
+	  (GLuint index), (index))                                                 \
+	X(glEndQuery, PFNGLENDQUERYPROC, (GLenum target), (target))                \
+	X(glFinish, PFNGLFINISHPROC, (void), ())                                   \
+	X(glFramebufferRenderbuffer, PFNGLFRAMEBUFFERRENDERBUFFERPROC,             \
+	  (GLenum target, GLenum attachment, GLenum renderbuffertarget,            \
+	   GLuint renderbuffer),                                                   \
+	  (target, attachment, renderbuffertarget, renderbuffer))                  \
+	X(glFramebufferTexture2D, PFNGLFRAMEBUFFERTEXTURE2DPROC,                   \
+	  (GLenum target, GLenum attachment, GLenum textarget, GLuint texture,     \
+	   GLint level),                                                           \
+	  (target, attachment, textarget, texture, level))                         \
+	X(glGenBuffers, PFNGLGENBUFFERSPROC, (GLsizei n, GLuint *buffers),         \
+	  (n, buffers))                                                            \
+	X(glGenFramebuffers, PFNGLGENFRAMEBUFFERSPROC,                             \
+	  (GLsizei n, GLuint *framebuffers), (n, framebuffers))                    \
+	X(glGenQueries, PFNGLGENQUERIESPROC, (GLsizei n, GLuint *ids), (n, ids))   \
+	X(glGenRenderbuffers, PFNGLGENRENDERBUFFERSPROC,                           \
+	  (GLsizei n, GLuint *renderbuffers), (n, renderbuffers))                  \
+	X(glGenTextures, PFNGLGENTEXTURESPROC, (GLsizei n, GLuint *textures),      \
+	  (n, textures))                                                           \
+	X(glGenVertexArrays, PFNGLGENVERTEXARRAYSPROC,                             \
+	  (GLsizei n, GLuint *arrays), (n, arrays))                                \
+	X(glGetIntegerv, PFNGLGETINTEGERVPROC, (GLenum pname, GLint *data),        \
+	  (pname, data))                                                           \
+	X(glGetQueryObjectiv, PFNGLGETQUERYOBJECTIVPROC,                           \
+	  (GLuint id, GLenum pname, GLint *params), (id, pname, params))           \
+	X(glGetQueryObjectui64v, PFNGLGETQUERYOBJECTUI64VPROC,                     \
+	  (GLuint id, GLenum pname, GLuint64 *params), (id, pname, params))        \
+	X(glGetShaderInfoLog, PFNGLGETSHADERINFOLOGPROC,                           \
+	  (GLuint shader, GLsizei bufSize, GLsizei *length, GLchar *infoLog),      \
+	  (shader, bufSize, length, infoLog))                                      \
+	X(glGetShaderiv, PFNGLGETSHADERIVPROC,                                     \
+	  (GLuint shader, GLenum pname, GLint *params), (shader, pname, params))   \
+	X(glLinkProgram, PFNGLLINKPROGRAMPROC, (GLuint program), (program))        \
+	X(glMultiDrawArraysIndirect, PFNGLMULTIDRAWARRAYSINDIRECTPROC,             \
+	  (GLenum mode, const void *indirect, GLsizei drawcount, GLsizei stride),  \
+	  (mode, indirect, drawcount, stride))                                     \
+	X(glMultiDrawElementsIndirect, PFNGLMULTIDRAWELEMENTSINDIRECTPROC,         \
+	  (GLenum mode, GLenum type, const void *indirect, GLsizei drawcount,      \
+	   GLsizei stride),                                                        \
+	  (mode, type, indirect, drawcount, stride))                               \
+	X(glPixelStorei, PFNGLPIXELSTOREIPROC, (GLenum pname, GLint param),        \
+	  (pname, param))                                                          \
+	X(glQueryCounter, PFNGLQUERYCOUNTERPROC, (GLuint id, GLenum target),       \
+	  (id, target))                                                            \
+	X(glReadPixels, PFNGLREADPIXELSPROC,                                       \
+	  (GLint x, GLint y, GLsizei width, GLsizei height, GLenum format,         \
+	   GLenum type, void *pixels),                                             \
+	  (x, y, width, height, format, type, pixels))                             \
+	X(glRenderbufferStorage, PFNGLRENDERBUFFERSTORAGEPROC,                     \
+	  (GLenum target, GLenum internalformat, GLsizei width, GLsizei height),   \
+	  (target, internalformat, width, height))                                 \
+	X(glShaderSource, PFNGLSHADERSOURCEPROC,                                   \
+	  (GLuint shader, GLsizei count, const GLchar *const *string,              \
+	   const GLint *length),                                                   \
+	  (shader, count, string, length))                                         \
+	X(glTexParameteri, PFNGLTEXPARAMETERIPROC,                                 \
+	  (GLenum target, GLenum pname, GLint param), (target, pname, param))      \
+	X(glUseProgram, PFNGLUSEPROGRAMPROC, (GLuint program), (program))          \
+	X(glVertexAttribDivisor, PFNGLVERTEXATTRIBDIVISORPROC,                     \
+	  (GLuint index, GLuint divisor), (index, divisor))                        \
+	X(glVertexAttribPointer, PFNGLVERTEXATTRIBPOINTERPROC,                     \
+	  (GLuint index, GLint size, GLenum type, GLboolean normalized,            \
+	   GLsizei stride, const void *pointer),                                   \
+	  (index, size, type, normalized, stride, pointer))                        \
+	X(glViewport, PFNGLVIEWPORTPROC,                                           \
+	  (GLint x, GLint y, GLsizei width, GLsizei height),                       \
+	  (x, y, width, height))
+
+// Functions returning a value, as (name, pointer type, return type,
+// parameters, arguments)
+#define GL_RETURNING_FUNCTIONS(X)                                              \
+	X(glCheckFramebufferStatus, PFNGLCHECKFRAMEBUFFERSTATUSPROC, GLenum,       \
+	  (GLenum target), (target))                                               \
+	X(glClientWaitSync, PFNGLCLIENTWAITSYNCPROC, GLenum,                       \
+	  (GLsync sync, GLbitfield flags, GLuint64 timeout),                       \
+	  (sync, flags, timeout))                                                  \
+	X(glCreateProgram, PFNGLCREATEPROGRAMPROC, GLuint, (void), ())             \
+	X(glCreateShader, PFNGLCREATESHADERPROC, GLuint, (GLenum type), (type))    \
+	X(glFenceSync, PFNGLFENCESYNCPROC, GLsync,                                 \
+	  (GLenum condition, GLbitfield flags), (condition, flags))                \
+	X(glGetString, PFNGLGETSTRINGPROC, const GLubyte *, (GLenum name),         \
+	  (name))                                                                  \
+	X(glGetUniformLocation, PFNGLGETUNIFORMLOCATIONPROC, GLint,                \
+	  (GLuint program, const GLchar *name), (program, name))                   \
+	X(glMapBufferRange, PFNGLMAPBUFFERRANGEPROC, void *,                       \
+	  (GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access),  \
+	  (target, offset, length, access))                                        \
+	X(glUnmapBuffer, PFNGLUNMAPBUFFERPROC, GLboolean, (GLenum target),         \
+	  (target))
+
+// Functions that upload data, as (name, pointer type, FrameCounts field,
+// bytes uploaded, parameters, arguments)
+#define GL_UPLOADING_FUNCTIONS(X)                                              \
+	X(glBufferData, PFNGLBUFFERDATAPROC, buffer_bytes,                         \
+	  data != NULL ? size : 0,                                                 \
+	  (GLenum target, GLsizeiptr size, const void *data, GLenum usage),        \
+	  (target, size, data, usage))                                             \
+	X(glBufferSubData, PFNGLBUFFERSUBDATAPROC, buffer_bytes, size,             \
+	  (GLenum target, GLintptr offset, GLsizeiptr size, const void *data),     \
+	  (target, offset, size, data))                                            \
+	X(glBufferStorage, PFNGLBUFFERSTORAGEPROC, buffer_bytes,                   \
+	  data != NULL ? size : 0,                                                 \
+	  (GLenum target, GLsizeiptr size, const void *data, GLbitfield flags),    \
+	  (target, size, data, flags))                                             \
+	X(glUniform1i, PFNGLUNIFORM1IPROC, uniform_bytes, sizeof(GLint),           \
+	  (GLint location, GLint v0), (location, v0))                              \
+	X(glUniform1f, PFNGLUNIFORM1FPROC, uniform_bytes, sizeof(GLfloat),         \
+	  (GLint location, GLfloat v0), (location, v0))                            \
+	X(glUniform2f, PFNGLUNIFORM2FPROC, uniform_bytes, 2 * sizeof(GLfloat),     \
+	  (GLint location, GLfloat v0, GLfloat v1), (location, v0, v1))            \
+	X(glUniform3fv, PFNGLUNIFORM3FVPROC, uniform_bytes,                        \
+	  count * 3 * sizeof(GLfloat),                                             \
+	  (GLint location, GLsizei count, const GLfloat *value),                   \
+	  (location, count, value))                                                \
+	X(glUniform4fv, PFNGLUNIFORM4FVPROC, uniform_bytes,                        \
+	  count * 4 * sizeof(GLfloat),                                             \
+	  (GLint location, GLsizei count, const GLfloat *value),                   \
+	  (location, count, value))                                                \
+	X(glUniformMatrix4fv, PFNGLUNIFORMMATRIX4FVPROC, uniform_bytes,            \
+	  count * 16 * sizeof(GLfloat),                                            \
+	  (GLint location, GLsizei count, GLboolean transpose,                     \
+	   const GLfloat *value),                                                  \
+	  (location, count, transpose, value))                                     \
+	X(glTexImage2D, PFNGLTEXIMAGE2DPROC, texture_bytes,                        \
+	  pixels != NULL ? pixel_bytes(width, height, format, type) : 0,           \
+	  (GLenum target, GLint level, GLint internalformat, GLsizei width,        \
+	   GLsizei height, GLint border, GLenum format, GLenum type,               \
+	   const void *pixels),                                                    \
+	  (target, level, internalformat, width, height, border, format, type,     \
+	   pixels))                                                                \
+	X(glTexSubImage2D, PFNGLTEXSUBIMAGE2DPROC, texture_bytes,                  \
+	  pixel_bytes(width, height, format, type),                                \
+	  (GLenum target, GLint level, GLint xoffset, GLint yoffset,               \
+	   GLsizei width, GLsizei height, GLenum format, GLenum type,              \
+	   const void *pixels),                                                    \
+	  (target, level, xoffset, yoffset, width, height, format, type, pixels))
+
+#define CALL_ID(name, ...) CALL_##name,
+typedef enum CallID {
+	GL_VOID_FUNCTIONS(CALL_ID) GL_RETURNING_FUNCTIONS(CALL_ID)
+	    GL_UPLOADING_FUNCTIONS(CALL_ID) CALL_COUNT
+} CallID;
+#undef CALL_ID
+
+#define CALL_NAME(name, ...) #name,
+static const char *call_names[CALL_COUNT] = {
+    GL_VOID_FUNCTIONS(CALL_NAME) GL_RETURNING_FUNCTIONS(CALL_NAME)
+        GL_UPLOADING_FUNCTIONS(CALL_NAME)};
+#undef CALL_NAME
+
+// What was counted over some number of frames
+typedef struct FrameCounts {
+	Uint64 calls[CALL_COUNT];
+	Uint64 buffer_bytes;
+	Uint64 uniform_bytes;
+	Uint64 texture_bytes;
+} FrameCounts;
+
+static bool enabled = false;
+static FrameCounts current; // Frame being drawn
+static FrameCounts last;    // Last complete frame
+static FrameCounts total;   // Every complete frame
+static Uint64 peak_calls[CALL_COUNT];
+static Uint64 frames = 0;
+
+// Calls of one function in one frame above which it is reported, 0 for none
+static Uint64 call_budget = 0;
+static bool over_budget[CALL_COUNT];
+
+static Uint64 performance_warnings = 0;
+static Uint64 errors = 0;
+static Uint64 messages = 0;
+
+// Bytes of a `width` by `height` image of `format` and `type`, ignoring row
+// alignment.
+static Uint64 pixel_bytes(GLsizei width, GLsizei height, GLenum format,
+                          GLenum type) {
+	Uint64 components = 4;
+	switch (format) {
+	case GL_RED:
+	case GL_RED_INTEGER:
+	case GL_DEPTH_COMPONENT:
+		components = 1;
+		break;
+	case GL_RG:
+	case GL_RG_INTEGER:
+		components = 2;
+		break;
+	case GL_RGB:
+	case GL_BGR:
+		components = 3;
+		break;
+	}
+
+	Uint64 size = 4;
+	switch (type) {
+	case GL_UNSIGNED_BYTE:
+	case GL_BYTE:
+		size = 1;
+		break;
+	case GL_UNSIGNED_SHORT:
+	case GL_SHORT:
+	case GL_HALF_FLOAT:
+		size = 2;
+		break;
+	}
+	return (Uint64)width * (Uint64)height * components * size;
+}
+
+// The wrappers, which count and call the function they replaced
+
+#define WRAP_VOID(name, type, params, args)                                    \
+	static type real_##name;                                                   \
+	static void APIENTRY counted_##name params {                               \
+		current.calls[CALL_##name]++;                                          \
+		real_##name args;                                                      \
+	}
+GL_VOID_FUNCTIONS(WRAP_VOID)
+#undef WRAP_VOID
+
+#define WRAP_RETURNING(name, type, result, params, args)                       \
+	static type real_##name;                                                   \
+	static result APIENTRY counted_##name params {                             \
+		current.calls[CALL_##name]++;                                          \
+		return real_##name args;                                               \
+	}
+GL_RETURNING_FUNCTIONS(WRAP_RETURNING)
+#undef WRAP_RETURNING
+
+#define WRAP_UPLOADING(name, type, counter, bytes, params, args)               \
+	static type real_##name;                                                   \
+	static void APIENTRY counted_##name params {                               \
+		current.calls[CALL_##name]++;                                          \
+		current.counter += (Uint64)(bytes);                                    \
+		real_##name args;                                                      \
+	}
+GL_UPLOADING_FUNCTIONS(WRAP_UPLOADING)
+#undef WRAP_UPLOADING
+
+static void APIENTRY debug_message(GLenum source, GLenum type, GLuint id,
+                                   GLenum severity, GLsizei length,
+                                   const GLchar *message,
+                                   const void *user_param) {
+	(void)source;
+	(void)severity;
+	(void)length;
+	(void)user_param;
+
+	bool performance = type == GL_DEBUG_TYPE_PERFORMANCE;
+	if (performance) {
+		performance_warnings++;
+	} else {
+		errors++;
+	}
+	if (messages++ < GL_STATS_MESSAGES_PRINTED) {
+		printf("GL %s %u: %s\n", performance ? "performance warning" : "error",
+		       id, message);
+	}
+}
+
+void EnableGLStats(void) {
+	if (enabled) {
+		return;
+	}
+	enabled = true;
+
+	const char *budget = SDL_getenv("SIERPINSKI_GL_CALL_BUDGET");
+	if (budget != NULL && atoi(budget) > 0) {
+		call_budget = (Uint64)atoi(budget);
+	}
+
+	// Set up before wrapping, so it isn't counted in the first frame. The
+	// messages are synchronous so they arrive on this thread, during the
+	// call that caused them.
+	if (gl_extensions.debug_output) {
+		glEnable(GL_DEBUG_OUTPUT);
+		glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+		glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DONT_CARE, 0,
+		                      NULL, GL_FALSE);
+		glDebugMessageControl(GL_DONT_CARE, GL_DEBUG_TYPE_PERFORMANCE,
+		                      GL_DONT_CARE, 0, NULL, GL_TRUE);
+		glDebugMessageControl(GL_DONT_CARE, GL_DEBUG_TYPE_ERROR, GL_DONT_CARE,
+		                      0, NULL, GL_TRUE);
+		glDebugMessageCallback(debug_message, NULL);
+	} else {
+		printf("No KHR_debug, GL driver warnings won't be reported\n");
+	}
+
+	// `name` expands to glad's (or glext's) pointer, NULL if not loaded
+#define INSTALL(name, type, ...)                                               \
+	if (name != NULL) {                                                        \
+		real_##name = name;                                                    \
+		name = counted_##name;                                                 \
+	}
+	GL_VOID_FUNCTIONS(INSTALL)
+	GL_RETURNING_FUNCTIONS(INSTALL)
+	GL_UPLOADING_FUNCTIONS(INSTALL)
+#undef INSTALL
+}
+
+bool GLStatsEnabled(void) { return enabled; }
+
+void EndGLStatsFrame(void) {
+	if (!enabled) {
+		return;
+	}
+
+	Uint64 calls = 0;
+	for (int i = 0; i < CALL_COUNT; i++) {
+		calls += current.calls[i];
+		total.calls[i] += current.calls[i];
+		if (current.calls[i] > peak_calls[i]) {
+			peak_calls[i] = current.calls[i];
+		}
+		if (call_budget > 0 && current.calls[i] > call_budget &&
+		    !over_budget[i]) {
+			over_budget[i] = true;
+			printf("%s called %llu times in one frame, over the budget of "
+			       "%llu\n",
+			       call_names[i], (unsigned long long)current.calls[i],
+			       (unsigned long long)call_budget);
+		}
+	}
+	total.buffer_bytes += current.buffer_bytes;
+	total.uniform_bytes += current.uniform_bytes;
+	total.texture_bytes += current.texture_bytes;
+	frames++;
+
+	TraceCounter("gl calls", (double)calls);
+	TraceCounter("gl bytes uploaded",
+	             (double)(current.buffer_bytes + current.uniform_bytes +
+	                      current.texture_bytes));
+
+	last = current;
+	memset(&current, 0, sizeof(current));
+}
+
+// Sorts function indices by calls last frame, then in total, most first.
+static int compare_calls(const void *a, const void *b) {
+	int i = *(const int *)a;
+	int j = *(const int *)b;
+	if (last.calls[i] != last.calls[j]) {
+		return last.calls[i] < last.calls[j] ? 1 : -1;
+	}
+	if (total.calls[i] != total.calls[j]) {
+		return total.calls[i] < total.calls[j] ? 1 : -1;
+	}
+	return i - j;
+}
+
+void PrintGLStats(void) {
+	if (!enabled) {
+		printf("GL stats are off, set SIERPINSKI_GL_STATS to count calls\n");
+		return;
+	}
+	if (frames == 0) {
+		printf("No frames counted yet\n");
+		return;
+	}
+
+	int order[CALL_COUNT];
+	for (int i = 0; i < CALL_COUNT; i++) {
+		order[i] = i;
+	}
+	qsort(order, CALL_COUNT, sizeof(int), compare_calls);
+
+	printf("GL calls over %llu frames:\n", (unsigned long long)frames);
+	printf("%28s %12s %12s %12s\n", "function", "last frame", "average",
+	       "peak");
+	for (int i = 0; i < CALL_COUNT; i++) {
+		int f = order[i];
+		if (total.calls[f] == 0) {
+			continue;
+		}
+		printf("%28s %12llu %12.1f %12llu\n", call_names[f],
+		       (unsigned long long)last.calls[f],
+		       (double)total.calls[f] / (double)frames,
+		       (unsigned long long)peak_calls[f]);
+	}
+
+	GLStatsSummary summary = GetGLStats();
+	printf("Bytes uploaded per frame: %.0f to buffers, %.0f to uniforms, "
+	       "%.0f to textures\n",
+	       summary.buffer_bytes, summary.uniform_bytes, summary.texture_bytes);
+	printf("Driver messages: %llu performance warnings, %llu errors\n",
+	       (unsigned long long)performance_warnings,
+	       (unsigned long long)errors);
+}
+
+GLStatsSummary GetGLStats(void) {
+	GLStatsSummary summary = {frames, 0.0, 0.0, 0.0, 0.0,
+	                          performance_warnings, errors};
+	if (frames == 0) {
+		return summary;
+	}
+
+	Uint64 calls = 0;
+	for (int i = 0; i < CALL_COUNT; i++) {
+		calls += total.calls[i];
+	}
+	summary.calls = (double)calls / (double)frames;
+	summary.buffer_bytes = (double)total.buffer_bytes / (double)frames;
+	summary.uniform_bytes = (double)total.uniform_bytes / (double)frames;
+	summary.texture_bytes = (double)total.texture_bytes / (double)frames;
+	return summary;
+}
@@ -0,0 +1,55 @@
+#ifndef GLSTATS_H
+#define GLSTATS_H
+
+#include <SDL3/SDL.h>
+
+// Driver messages printed in full, later ones are only counted
+#define GL_STATS_MESSAGES_PRINTED 16
+
+// Averages over the frames counted so far, see GetGLStats
+typedef struct GLStatsSummary {
+	Uint64 frames;
+	double calls;         // GL calls per frame
+	double buffer_bytes;  // Bytes per frame passed to glBuffer(Sub)Data/Storage
+	double uniform_bytes; // Bytes per frame passed to glUniform*
+	double texture_bytes; // Bytes per frame passed to glTex(Sub)Image2D
+	Uint64 performance_warnings;
+	Uint64 errors;
+} GLStatsSummary;
+
+/**
+ * Count the GL calls made each frame, per function, and the bytes uploaded
+ * through them, and report the driver's KHR_debug performance warnings and
+ * errors.
+ *
+ * glad calls GL through a function pointer per entry point, so enabling the
+ * stats swaps the pointers of the functions this program uses for wrappers
+ * that count and forward. Until then nothing is wrapped and GL calls cost
+ * exactly what they did. Writes into mapped buffers aren't seen.
+ *
+ * Must be called after LoadGLExtensions, from the thread GL is used on. For
+ * the warnings, the context should be created with SDL_GL_CONTEXT_DEBUG_FLAG.
+ *
+ * With SIERPINSKI_GL_CALL_BUDGET set to a number, any function called more
+ * often than that in one frame is reported the first time it happens (e.g. a
+ * glUniformMatrix4fv per leaf).
+ */
+void EnableGLStats(void);
+
+// Whether EnableGLStats has been called.
+bool GLStatsEnabled(void);
+
+// Close the current frame's counts. Call once per frame, after the swap.
+void EndGLStatsFrame(void);
+
+/**
+ * Print the functions called last frame with their calls last frame, on
+ * average and at most per frame, then the bytes uploaded and driver
+ * messages.
+ */
+void PrintGLStats(void);
+
+// Calls and uploads per frame so far.
+GLStatsSummary GetGLStats(void);
+
+#endif // GLSTATS_H
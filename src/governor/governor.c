@@ -0,0 +1,225 @@
+#include "governor/governor.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "leaves/leaves.h"
+#include "memory/memory.h"
+#include "mesh/mesh.h"
+
+// Starting estimates of the time per unit of work, in ns
+#define RECURSIVE_DRAW_NS 1500.0 // Per draw call, uniform upload included
+#define INSTANCED_VERTEX_NS 0.5  // Per vertex shaded
+#define SPLAT_FRAME_NS 30e6      // Per accumulation of the default points
+
+// Weight of a new frame in the measured averages
+#define MEASURE_WEIGHT 0.1
+
+#define MIB (1024.0 * 1024.0)
+
+const char *render_mode_names[RENDER_MODE_COUNT] = {"recursive", "splat",
+                                                    "instanced"};
+
+// Modes from most to least expensive at depth, the order GovernDepth falls
+// back in.
+static const RenderMode fallback_order[RENDER_MODE_COUNT] = {
+    RENDER_RECURSIVE, RENDER_INSTANCED, RENDER_SPLAT};
+
+// Read a budget from the environment, or return `fallback`.
+static double budget_from_env(const char *name, double fallback) {
+	const char *value = SDL_getenv(name);
+	if (value == NULL) {
+		return fallback;
+	}
+	double parsed = atof(value);
+	return parsed > 0.0 ? parsed : fallback;
+}
+
+// Units of work a frame `depth` deep of `ifs` takes in `mode`.
+static double work_units(const IFS *ifs, RenderMode mode, int depth) {
+	switch (mode) {
+	case RENDER_RECURSIVE:
+		return (double)LeafCount(depth);
+	case RENDER_INSTANCED:
+		return (double)IFSLeafCount(ifs, depth) * ifs->base_vertex_count;
+	default:
+		return 1.0;
+	}
+}
+
+// Whether `mode` can draw the fractal. Only instanced mode isn't
+// pyramid-specific.
+static bool can_draw(const Governor *governor, RenderMode mode) {
+	if (governor->unavailable[mode]) {
+		return false;
+	}
+	return mode == RENDER_INSTANCED || governor->ifs == &ifs_sierpinski_pyramid;
+}
+
+Governor *CreateGovernor(int width, int height) {
+	Governor *governor =
+	    (Governor *)TaggedCalloc(MEMORY_APP, 1, sizeof(Governor));
+	if (governor == NULL) {
+		perror("Could not allocate memory for governor");
+		return NULL;
+	}
+
+	double cpu_mb = SDL_GetSystemRAM() / 2.0;
+	if (cpu_mb <= 0.0 || cpu_mb > GOVERNOR_CPU_BUDGET_MB) {
+		cpu_mb = GOVERNOR_CPU_BUDGET_MB;
+	}
+	cpu_mb = budget_from_env("SIERPINSKI_CPU_BUDGET_MB", cpu_mb);
+
+	governor->cpu_budget = (Uint64)(cpu_mb * MIB);
+	governor->gpu_budget = (Uint64)(
+	    budget_from_env("SIERPINSKI_GPU_BUDGET_MB", GOVERNOR_GPU_BUDGET_MB) *
+	    MIB);
+	governor->frame_budget_ms =
+	    budget_from_env("SIERPINSKI_FRAME_BUDGET_MS", GOVERNOR_FRAME_BUDGET_MS);
+	governor->width = width;
+	governor->height = height;
+	governor->ifs = &ifs_sierpinski_pyramid;
+
+	governor->unit_ns[RENDER_RECURSIVE] = RECURSIVE_DRAW_NS;
+	governor->unit_ns[RENDER_INSTANCED] = INSTANCED_VERTEX_NS;
+	governor->unit_ns[RENDER_SPLAT] = SPLAT_FRAME_NS;
+
+	printf("Budgets: %.0f MiB CPU, %.0f MiB GPU, %.1f ms per frame\n",
+	       governor->cpu_budget / MIB, governor->gpu_budget / MIB,
+	       governor->frame_budget_ms);
+	return governor;
+}
+
+void DestroyGovernor(Governor *governor) { TaggedFree(governor); }
+
+DepthCost PredictDepthCost(const Governor *governor, RenderMode mode,
+                           int depth, int block_depth) {
+	DepthCost cost = {0, 0, 0.0};
+	const IFS *ifs = governor->ifs;
+	Uint64 pixels = (Uint64)governor->width * governor->height;
+
+	switch (mode) {
+	case RENDER_RECURSIVE:
+		// Only the base pyramid is stored, the recursion is on the stack
+		cost.gpu_bytes = sizeof(PackedVertex) * ifs->base_vertex_count;
+		break;
+
+	case RENDER_INSTANCED: {
+		if (block_depth > depth) {
+			block_depth = depth;
+		}
+		Uint64 instances =
+		    sizeof(Leaf) * IFSLeafCount(ifs, depth - block_depth);
+		// At most one distinct vertex per index
+		Uint64 mesh = (sizeof(PackedVertex) + sizeof(Uint32)) *
+		              ifs->base_vertex_count * IFSLeafCount(ifs, block_depth);
+		// The baked mesh is only on the CPU while it's being uploaded
+		cost.cpu_bytes = instances + mesh;
+		cost.gpu_bytes = instances + mesh;
+		break;
+	}
+
+	default: {
+		int threads = SDL_GetNumLogicalCPUCores();
+		if (threads < 1) {
+			threads = 1;
+		}
+		// A histogram per worker, the tone-mapped image and its texture
+		cost.cpu_bytes = sizeof(Uint32) * pixels * threads + pixels;
+		cost.gpu_bytes = pixels;
+		break;
+	}
+	}
+
+	double unit_ns = governor->unit_ns[mode];
+	if (governor->measured_ns[mode] > unit_ns) {
+		unit_ns = governor->measured_ns[mode];
+	}
+	cost.frame_ms = unit_ns * work_units(ifs, mode, depth) / 1e6;
+	return cost;
+}
+
+void ObserveFrame(Governor *governor, RenderMode mode, int depth,
+                  Uint64 draw_ns) {
+	if (mode != RENDER_SPLAT && depth < GOVERNOR_MIN_CALIBRATION_DEPTH) {
+		return;
+	}
+
+	double unit_ns = (double)draw_ns / work_units(governor->ifs, mode, depth);
+	double *measured = &governor->measured_ns[mode];
+	if (*measured == 0.0) {
+		*measured = unit_ns;
+	} else {
+		*measured += MEASURE_WEIGHT * (unit_ns - *measured);
+	}
+}
+
+/**
+ * Check `cost` against the budgets. Returns false and describes the first
+ * budget exceeded in `reason` if it doesn't fit.
+ */
+static bool within_budget(const Governor *governor, DepthCost cost,
+                          char *reason, size_t size) {
+	if (cost.cpu_bytes > governor->cpu_budget) {
+		snprintf(reason, size, "%.1f MiB of CPU memory (budget %.0f MiB)",
+		         cost.cpu_bytes / MIB, governor->cpu_budget / MIB);
+		return false;
+	}
+	if (cost.gpu_bytes > governor->gpu_budget) {
+		snprintf(reason, size, "%.1f MiB of GPU memory (budget %.0f MiB)",
+		         cost.gpu_bytes / MIB, governor->gpu_budget / MIB);
+		return false;
+	}
+	if (cost.frame_ms > governor->frame_budget_ms) {
+		snprintf(reason, size, "%.1f ms per frame (budget %.1f ms)",
+		         cost.frame_ms, governor->frame_budget_ms);
+		return false;
+	}
+	return true;
+}
+
+bool GovernDepth(Governor *governor, int depth, int block_depth,
+                 RenderMode *mode) {
+	// Fall back from the current mode, or from the most expensive one if the
+	// current mode can't draw the IFS at all
+	int first = 0;
+	while (can_draw(governor, *mode) && fallback_order[first] != *mode) {
+		first++;
+	}
+
+	char reason[128] = "no mode can draw it";
+	for (int i = first; i < RENDER_MODE_COUNT; i++) {
+		RenderMode candidate = fallback_order[i];
+		if (!can_draw(governor, candidate)) {
+			continue;
+		}
+
+		DepthCost cost =
+		    PredictDepthCost(governor, candidate, depth, block_depth);
+
+		char candidate_reason[128];
+		if (!within_budget(governor, cost, candidate_reason,
+		                   sizeof(candidate_reason))) {
+			printf("Depth %d in %s mode would need %s\n", depth,
+			       render_mode_names[candidate], candidate_reason);
+			snprintf(reason, sizeof(reason), "%s", candidate_reason);
+			continue;
+		}
+
+		if (candidate != *mode) {
+			printf("Switching to %s mode for depth %d: ",
+			       render_mode_names[candidate], depth);
+			*mode = candidate;
+		} else {
+			printf("Depth %d in %s mode: ", depth,
+			       render_mode_names[candidate]);
+		}
+		printf("%.1f MiB CPU, %.1f MiB GPU, %.1f ms per frame predicted\n",
+		       cost.cpu_bytes / MIB, cost.gpu_bytes / MIB, cost.frame_ms);
+		return true;
+	}
+
+	printf("Refusing depth %d, it doesn't fit the budgets in any mode (%s)\n",
+	       depth, reason);
+	return false;
+}
@@ -0,0 +1,103 @@
+#ifndef GOVERNOR_H
+#define GOVERNOR_H
+
+#include <SDL3/SDL.h>
+
+#include "ifs/ifs.h"
+
+// The different ways the fractal can be rendered, cycled with the M key.
+typedef enum RenderMode {
+	RENDER_RECURSIVE, // One draw call per pyramid, see draw_serpinskis_triangle
+	RENDER_SPLAT,     // Chaos-game points splatted on the CPU, see splat.h
+	RENDER_INSTANCED, // Baked blocks instanced over the leaves, see blocks.h
+	RENDER_MODE_COUNT,
+} RenderMode;
+
+extern const char *render_mode_names[RENDER_MODE_COUNT];
+
+// Default budgets. The CPU budget defaults to half the system RAM, capped by
+// this. Each can be overridden in MiB or ms with the environment variables
+// SIERPINSKI_CPU_BUDGET_MB, SIERPINSKI_GPU_BUDGET_MB and
+// SIERPINSKI_FRAME_BUDGET_MS.
+#define GOVERNOR_CPU_BUDGET_MB 4096
+#define GOVERNOR_GPU_BUDGET_MB 512
+#define GOVERNOR_FRAME_BUDGET_MS 50.0
+
+// Shallower frames are dominated by fixed costs, so they aren't used to
+// calibrate the per-unit cost.
+#define GOVERNOR_MIN_CALIBRATION_DEPTH 4
+
+// Predicted resources for drawing the fractal at some depth.
+typedef struct DepthCost {
+	Uint64 cpu_bytes;
+	Uint64 gpu_bytes;
+	double frame_ms;
+} DepthCost;
+
+/**
+ * Decides whether the fractal can be subdivided further.
+ *
+ * Each render mode's cost grows with its own unit of work: draw calls for
+ * recursive (5^n), vertices for instanced (18 * 5^n for the pyramid, base
+ * vertices * N^n for an IFS of N maps) and one accumulation for splat,
+ * whose cost doesn't depend on the depth. The time per unit
+ * starts at a conservative estimate and is raised from measured frames,
+ * never lowered, since the draw submission time ObserveFrame is given
+ * doesn't include the GPU's share of the work.
+ */
+typedef struct Governor {
+	Uint64 cpu_budget; // Bytes
+	Uint64 gpu_budget; // Bytes
+	double frame_budget_ms;
+
+	int width;
+	int height;
+
+	// The fractal drawn. Only instanced mode can draw IFSs other than the
+	// pyramid.
+	const IFS *ifs;
+
+	// Modes that failed to start, e.g. the splatter's worker threads
+	bool unavailable[RENDER_MODE_COUNT];
+
+	double unit_ns[RENDER_MODE_COUNT];     // Time per unit of work, per mode
+	double measured_ns[RENDER_MODE_COUNT]; // Running average, 0 if unmeasured
+} Governor;
+
+/**
+ * Create a governor with the default or environment budgets, for a
+ * `width` x `height` window (which sizes the splat buffers).
+ */
+Governor *CreateGovernor(int width, int height);
+
+// Free a governor.
+void DestroyGovernor(Governor *governor);
+
+/**
+ * Predict the memory and frame time of drawing `depth` deep in `mode`, with
+ * a block of `block_depth` for instanced mode.
+ */
+DepthCost PredictDepthCost(const Governor *governor, RenderMode mode,
+                           int depth, int block_depth);
+
+/**
+ * Feed the time `draw_ns` spent drawing a frame `depth` deep in `mode`. It
+ * should only cover the draw itself (an accumulation for splat), not
+ * rebuilding the leaves or the mesh, which would inflate the per-unit cost.
+ */
+void ObserveFrame(Governor *governor, RenderMode mode, int depth,
+                  Uint64 draw_ns);
+
+/**
+ * Check whether `depth` fits the budgets in `*mode`.
+ *
+ * If it doesn't, the cheaper modes are tried in turn (instanced, then splat)
+ * and `*mode` is switched to the first one that fits. Modes that can't draw
+ * `governor->ifs` or are unavailable are skipped. Returns false if none
+ * do, in which case the depth shouldn't be used. The decision and the
+ * reason for it are printed.
+ */
+bool GovernDepth(Governor *governor, int depth, int block_depth,
+                 RenderMode *mode);
+
+#endif // GOVERNOR_H
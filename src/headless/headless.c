@@ -0,0 +1,140 @@
+#include "headless/headless.h"
+
+#include <glad/glad.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "glext/glext.h"
+#include "glstats/glstats.h"
+#include "memory/memory.h"
+
+Headless *CreateHeadless(int width, int height) {
+	// Fall back to rendering without a display
+	if (!SDL_Init(SDL_INIT_VIDEO)) {
+		SDL_SetHint(SDL_HINT_VIDEO_DRIVER, "offscreen");
+		if (!SDL_Init(SDL_INIT_VIDEO)) {
+			printf("Could not initialize SDL video: %s\n", SDL_GetError());
+			return NULL;
+		}
+	}
+
+	Headless *headless =
+	    (Headless *)TaggedCalloc(MEMORY_APP, 1, sizeof(Headless));
+	if (headless == NULL) {
+		perror("Could not allocate memory for headless context");
+		SDL_Quit();
+		return NULL;
+	}
+	headless->width = width;
+	headless->height = height;
+
+	SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER, 1);
+	SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 4);
+	SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 3);
+	SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK,
+	                    SDL_GL_CONTEXT_PROFILE_CORE);
+	bool gl_stats = SDL_getenv("SIERPINSKI_GL_STATS") != NULL;
+	if (gl_stats) {
+		SDL_GL_SetAttribute(SDL_GL_CONTEXT_FLAGS, SDL_GL_CONTEXT_DEBUG_FLAG);
+	}
+
+	headless->window =
+	    SDL_CreateWindow("Sierpinski's Triangle (headless)", width, height,
+	                     SDL_WINDOW_OPENGL | SDL_WINDOW_HIDDEN);
+	if (headless->window == NULL) {
+		printf("Could not create a hidden window: %s\n", SDL_GetError());
+		DestroyHeadless(headless);
+		return NULL;
+	}
+
+	headless->context = SDL_GL_CreateContext(headless->window);
+	if (headless->context == NULL) {
+		SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 3);
+		SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 3);
+		headless->context = SDL_GL_CreateContext(headless->window);
+	}
+	if (headless->context == NULL) {
+		printf("Could not create a GL context: %s\n", SDL_GetError());
+		DestroyHeadless(headless);
+		return NULL;
+	}
+
+	gladLoadGLLoader((GLADloadproc)SDL_GL_GetProcAddress);
+	LoadGLExtensions();
+	if (gl_stats) {
+		EnableGLStats();
+	}
+
+	glGenRenderbuffers(1, &headless->color);
+	glBindRenderbuffer(GL_RENDERBUFFER, headless->color);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+	TrackGPUMemory(MEMORY_APP, GPU_OBJECT_RENDERBUFFER, headless->color,
+	               (Uint64)width * height * 4);
+
+	glGenRenderbuffers(1, &headless->depth);
+	glBindRenderbuffer(GL_RENDERBUFFER, headless->depth);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width,
+	                      height);
+	TrackGPUMemory(MEMORY_APP, GPU_OBJECT_RENDERBUFFER, headless->depth,
+	               (Uint64)width * height * 4);
+
+	glGenFramebuffers(1, &headless->framebuffer);
+	glBindFramebuffer(GL_FRAMEBUFFER, headless->framebuffer);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+	                          GL_RENDERBUFFER, headless->color);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT,
+	                          GL_RENDERBUFFER, headless->depth);
+	GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+	if (status != GL_FRAMEBUFFER_COMPLETE) {
+		printf("Could not create the headless framebuffer (0x%x)\n", status);
+		DestroyHeadless(headless);
+		return NULL;
+	}
+
+	glViewport(0, 0, width, height);
+	glEnable(GL_DEPTH_TEST);
+
+	return headless;
+}
+
+void DestroyHeadless(Headless *headless) {
+	if (headless->context != NULL) {
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		glDeleteFramebuffers(1, &headless->framebuffer);
+		ReleaseGPUMemory(GPU_OBJECT_RENDERBUFFER, headless->color);
+		ReleaseGPUMemory(GPU_OBJECT_RENDERBUFFER, headless->depth);
+		glDeleteRenderbuffers(1, &headless->color);
+		glDeleteRenderbuffers(1, &headless->depth);
+		SDL_GL_DestroyContext(headless->context);
+	}
+	if (headless->window != NULL) {
+		SDL_DestroyWindow(headless->window);
+	}
+	TaggedFree(headless);
+	SDL_Quit();
+}
+
+void ReadHeadlessPixels(Headless *headless, Uint8 *pixels) {
+	int width = headless->width;
+	int height = headless->height;
+	size_t row_bytes = (size_t)width * 4;
+
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, headless->framebuffer);
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+	glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+
+	// GL reads bottom up, swap the rows in place
+	Uint8 *row = (Uint8 *)TaggedMalloc(MEMORY_APP, row_bytes);
+	if (row == NULL) {
+		perror("Could not allocate memory for a row of pixels");
+		return;
+	}
+	for (int y = 0; y < height / 2; y++) {
+		Uint8 *top = pixels + (size_t)y * row_bytes;
+		Uint8 *bottom = pixels + (size_t)(height - 1 - y) * row_bytes;
+		memcpy(row, top, row_bytes);
+		memcpy(top, bottom, row_bytes);
+		memcpy(bottom, row, row_bytes);
+	}
+	TaggedFree(row);
+}
@@ -0,0 +1,44 @@
+#ifndef HEADLESS_H
+#define HEADLESS_H
+
+#include <SDL3/SDL.h>
+
+/**
+ * A GL context without a visible window, for the benchmarks and tests.
+ *
+ * The window is created hidden and everything is drawn into an offscreen
+ * framebuffer of the same size, so results don't depend on the window being
+ * mapped. Without a display SDL's offscreen video driver is used, which with
+ * Mesa's llvmpipe renders on the CPU.
+ *
+ * The context is created like the app's (4.3 core, falling back to 3.3), with
+ * the GL extensions loaded and GL stats enabled if SIERPINSKI_GL_STATS is
+ * set.
+ */
+typedef struct Headless {
+	int width;
+	int height;
+	SDL_Window *window;
+	SDL_GLContext context;
+	unsigned int framebuffer;
+	unsigned int color; // RGBA8 renderbuffer
+	unsigned int depth; // Renderbuffer
+} Headless;
+
+/**
+ * Initialize SDL's video, create the context and bind a `width` by `height`
+ * framebuffer with the depth test enabled. Returns NULL if no GL context
+ * could be created.
+ */
+Headless *CreateHeadless(int width, int height);
+
+// Delete the framebuffer, context and window, and quit SDL.
+void DestroyHeadless(Headless *headless);
+
+/**
+ * Read the framebuffer into `pixels`, `width * height` RGBA8 pixels with the
+ * top row first.
+ */
+void ReadHeadlessPixels(Headless *headless, Uint8 *pixels);
+
+#endif // HEADLESS_H
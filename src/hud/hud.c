@@ -0,0 +1,436 @@
+#include "hud/hud.h"
+
+#include <SDL3_ttf/SDL_ttf.h>
+#include <glad/glad.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "memory/memory.h"
+#include "trace/trace.h"
+
+// Width of the glyph atlas, the height is what the glyphs need
+#define ATLAS_WIDTH 512
+
+// Opaque texels in the atlas' corner, sampled by the background panel
+#define SOLID_SIZE 2
+
+// Pixels between the window edge, the panel edge and the text
+#define MARGIN 8
+
+// Fonts tried when SIERPINSKI_HUD_FONT isn't set
+static const char *default_fonts[] = {
+    "/usr/share/fonts/truetype/dejavu/DejaVuSansMono.ttf",
+    "/usr/share/fonts/TTF/DejaVuSansMono.ttf",
+    "/usr/share/fonts/dejavu-sans-mono-fonts/DejaVuSansMono.ttf",
+    "/System/Library/Fonts/Menlo.ttc",
+    "C:/Windows/Fonts/consola.ttf",
+};
+
+static const Uint8 text_color[4] = {255, 255, 255, 255};
+static const Uint8 panel_color[4] = {0, 0, 0, 160};
+
+static TTF_Font *open_font(void) {
+	const char *path = SDL_getenv("SIERPINSKI_HUD_FONT");
+	if (path != NULL) {
+		TTF_Font *font = TTF_OpenFont(path, HUD_FONT_SIZE);
+		if (font == NULL) {
+			printf("Could not open the HUD font %s: %s\n", path,
+			       SDL_GetError());
+		}
+		return font;
+	}
+
+	int count = (int)(sizeof(default_fonts) / sizeof(default_fonts[0]));
+	for (int i = 0; i < count; i++) {
+		TTF_Font *font = TTF_OpenFont(default_fonts[i], HUD_FONT_SIZE);
+		if (font != NULL) {
+			return font;
+		}
+	}
+	printf("No HUD font found, set SIERPINSKI_HUD_FONT to a .ttf file\n");
+	return NULL;
+}
+
+/**
+ * Render every glyph of `font`, pack them in rows into a single channel
+ * atlas after the solid corner, and upload it. Returns false if it couldn't
+ * be built.
+ */
+static bool build_atlas(HUD *hud, TTF_Font *font) {
+	SDL_Color white = {255, 255, 255, 255};
+	SDL_Surface *surfaces[HUD_GLYPH_COUNT] = {NULL};
+	Uint8 *texels = NULL;
+	bool built = false;
+
+	int x = SOLID_SIZE + 1;
+	int y = 0;
+	int row_height = SOLID_SIZE;
+	for (int i = 0; i < HUD_GLYPH_COUNT; i++) {
+		Uint32 ch = (Uint32)(HUD_FIRST_GLYPH + i);
+		HUDGlyph *glyph = &hud->glyphs[i];
+		int min_x, max_x, min_y, max_y;
+		if (!TTF_GetGlyphMetrics(font, ch, &min_x, &max_x, &min_y, &max_y,
+		                         &glyph->advance)) {
+			glyph->advance = 0;
+		}
+
+		// Blank glyphs (the space) only advance
+		SDL_Surface *surface = TTF_RenderGlyph_Blended(font, ch, white);
+		if (surface == NULL) {
+			continue;
+		}
+		if (surface->format != SDL_PIXELFORMAT_ARGB8888) {
+			SDL_Surface *converted =
+			    SDL_ConvertSurface(surface, SDL_PIXELFORMAT_ARGB8888);
+			SDL_DestroySurface(surface);
+			if (converted == NULL) {
+				printf("Could not convert a HUD glyph: %s\n", SDL_GetError());
+				goto done;
+			}
+			surface = converted;
+		}
+		surfaces[i] = surface;
+
+		if (x + surface->w > ATLAS_WIDTH) {
+			x = 0;
+			y += row_height + 1;
+			row_height = 0;
+		}
+		glyph->x = x;
+		glyph->y = y;
+		glyph->width = surface->w;
+		glyph->height = surface->h;
+		x += surface->w + 1;
+		if (surface->h > row_height) {
+			row_height = surface->h;
+		}
+	}
+
+	hud->atlas_width = ATLAS_WIDTH;
+	hud->atlas_height = y + row_height;
+
+	texels = (Uint8 *)TaggedCalloc(
+	    MEMORY_PROFILING, (size_t)hud->atlas_width * hud->atlas_height, 1);
+	if (texels == NULL) {
+		perror("Could not allocate memory for the HUD atlas");
+		goto done;
+	}
+	for (int ty = 0; ty < SOLID_SIZE; ty++) {
+		memset(texels + ty * hud->atlas_width, 255, SOLID_SIZE);
+	}
+
+	// The coverage is the glyph's alpha, the top byte of ARGB8888
+	for (int i = 0; i < HUD_GLYPH_COUNT; i++) {
+		SDL_Surface *surface = surfaces[i];
+		if (surface == NULL) {
+			continue;
+		}
+		const HUDGlyph *glyph = &hud->glyphs[i];
+		for (int gy = 0; gy < surface->h; gy++) {
+			const Uint32 *row =
+			    (const Uint32 *)((const Uint8 *)surface->pixels +
+			                     gy * surface->pitch);
+			Uint8 *out =
+			    texels + (glyph->y + gy) * hud->atlas_width + glyph->x;
+			for (int gx = 0; gx < surface->w; gx++) {
+				out[gx] = (Uint8)(row[gx] >> 24);
+			}
+		}
+	}
+
+	glGenTextures(1, &hud->atlas);
+	glBindTexture(GL_TEXTURE_2D, hud->atlas);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, hud->atlas_width, hud->atlas_height,
+	             0, GL_RED, GL_UNSIGNED_BYTE, texels);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	TrackGPUMemory(MEMORY_PROFILING, GPU_OBJECT_TEXTURE, hud->atlas,
+	               (Uint64)hud->atlas_width * hud->atlas_height);
+	// Glyphs are drawn at their size, texel for pixel
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	TaggedFree(texels);
+	built = true;
+
+done:
+	for (int i = 0; i < HUD_GLYPH_COUNT; i++) {
+		if (surfaces[i] != NULL) {
+			SDL_DestroySurface(surfaces[i]);
+		}
+	}
+	return built;
+}
+
+HUD *CreateHUD(int width, int height) {
+	if (!TTF_Init()) {
+		printf("Could not initialize SDL_ttf: %s\n", SDL_GetError());
+		return NULL;
+	}
+	TTF_Font *font = open_font();
+	if (font == NULL) {
+		TTF_Quit();
+		return NULL;
+	}
+
+	HUD *hud = (HUD *)TaggedCalloc(MEMORY_PROFILING, 1, sizeof(HUD));
+	if (hud == NULL) {
+		perror("Could not allocate memory for the HUD");
+		TTF_CloseFont(font);
+		TTF_Quit();
+		return NULL;
+	}
+	hud->width = width;
+	hud->height = height;
+	hud->line_height = TTF_GetFontHeight(font);
+
+	// The font isn't needed once its glyphs are in the atlas
+	TraceBegin("build HUD atlas");
+	bool built = build_atlas(hud, font);
+	TraceEnd("build HUD atlas");
+	TTF_CloseFont(font);
+	TTF_Quit();
+	if (!built) {
+		DestroyHUD(hud);
+		return NULL;
+	}
+
+	Uint64 buffer_bytes = sizeof(HUDVertex) * 6 * HUD_MAX_CHARS;
+	hud->vertices =
+	    (HUDVertex *)TaggedMalloc(MEMORY_PROFILING, (size_t)buffer_bytes);
+	if (hud->vertices == NULL) {
+		perror("Could not allocate memory for the HUD vertices");
+		DestroyHUD(hud);
+		return NULL;
+	}
+
+	glGenVertexArrays(1, &hud->vao);
+	glBindVertexArray(hud->vao);
+	glGenBuffers(1, &hud->vbo);
+	glBindBuffer(GL_ARRAY_BUFFER, hud->vbo);
+	glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)buffer_bytes, NULL,
+	             GL_DYNAMIC_DRAW);
+	TrackGPUMemory(MEMORY_PROFILING, GPU_OBJECT_BUFFER, hud->vbo,
+	               buffer_bytes);
+	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(HUDVertex),
+	                      (void *)offsetof(HUDVertex, x));
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(HUDVertex),
+	                      (void *)offsetof(HUDVertex, u));
+	glEnableVertexAttribArray(1);
+	glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(HUDVertex),
+	                      (void *)offsetof(HUDVertex, color));
+	glEnableVertexAttribArray(2);
+	glBindVertexArray(0);
+
+	hud->program = LoadShaderProgram("hud.vert", "hud.frag");
+	if (hud->program != NULL) {
+		hud->screen_uniform = glGetUniformLocation(*hud->program, "screen");
+	}
+
+	return hud;
+}
+
+void DestroyHUD(HUD *hud) {
+	if (hud->program != NULL) {
+		DeleteShaderProgram(hud->program);
+	}
+	glDeleteVertexArrays(1, &hud->vao);
+	ReleaseGPUMemory(GPU_OBJECT_BUFFER, hud->vbo);
+	ReleaseGPUMemory(GPU_OBJECT_TEXTURE, hud->atlas);
+	glDeleteBuffers(1, &hud->vbo);
+	glDeleteTextures(1, &hud->atlas);
+	TaggedFree(hud->vertices);
+	TaggedFree(hud);
+}
+
+// Append a quad from (x0, y0) to (x1, y1) showing the atlas texels from
+// (u0, v0) to (u1, v1).
+static void add_quad(HUD *hud, float x0, float y0, float x1, float y1, int u0,
+                     int v0, int u1, int v1, const Uint8 color[4]) {
+	if (hud->vertex_count + 6 > 6 * HUD_MAX_CHARS) {
+		return;
+	}
+
+	float su = 1.0f / (float)hud->atlas_width;
+	float sv = 1.0f / (float)hud->atlas_height;
+	HUDVertex corners[4] = {
+	    {x0, y0, u0 * su, v0 * sv, {color[0], color[1], color[2], color[3]}},
+	    {x1, y0, u1 * su, v0 * sv, {color[0], color[1], color[2], color[3]}},
+	    {x1, y1, u1 * su, v1 * sv, {color[0], color[1], color[2], color[3]}},
+	    {x0, y1, u0 * su, v1 * sv, {color[0], color[1], color[2], color[3]}},
+	};
+	static const int order[6] = {0, 1, 2, 0, 2, 3};
+	for (int i = 0; i < 6; i++) {
+		hud->vertices[hud->vertex_count++] = corners[order[i]];
+	}
+}
+
+// Width of `text` in pixels.
+static int text_width(const HUD *hud, const char *text) {
+	int width = 0;
+	for (const char *c = text; *c != '\0'; c++) {
+		int index = (unsigned char)*c - HUD_FIRST_GLYPH;
+		if (index < 0 || index >= HUD_GLYPH_COUNT) {
+			index = '?' - HUD_FIRST_GLYPH;
+		}
+		width += hud->glyphs[index].advance;
+	}
+	return width;
+}
+
+// Append the quads of `text` with its top left corner at (x, y).
+static void add_text(HUD *hud, int x, int y, const char *text) {
+	for (const char *c = text; *c != '\0'; c++) {
+		int index = (unsigned char)*c - HUD_FIRST_GLYPH;
+		if (index < 0 || index >= HUD_GLYPH_COUNT) {
+			index = '?' - HUD_FIRST_GLYPH;
+		}
+		const HUDGlyph *glyph = &hud->glyphs[index];
+		if (glyph->width > 0) {
+			add_quad(hud, (float)x, (float)y, (float)(x + glyph->width),
+			         (float)(y + glyph->height), glyph->x, glyph->y,
+			         glyph->x + glyph->width, glyph->y + glyph->height,
+			         text_color);
+		}
+		x += glyph->advance;
+	}
+}
+
+static int compare_ns(const void *a, const void *b) {
+	Uint64 x = *(const Uint64 *)a;
+	Uint64 y = *(const Uint64 *)b;
+	return (x > y) - (x < y);
+}
+
+// Lay the lines of text out into `hud->vertices` and upload them.
+static void rebuild_text(HUD *hud, const HUDStats *stats) {
+	// Frame time percentiles over the history recorded so far
+	Uint64 sorted[HUD_FRAME_HISTORY];
+	int count = hud->frames < HUD_FRAME_HISTORY ? (int)hud->frames
+	                                            : HUD_FRAME_HISTORY;
+	Uint64 sum = 0;
+	for (int i = 0; i < count; i++) {
+		sorted[i] = hud->frame_ns[i];
+		sum += sorted[i];
+	}
+	qsort(sorted, count, sizeof(Uint64), compare_ns);
+	double p50 = 0.0, p95 = 0.0, p99 = 0.0, fps = 0.0;
+	if (count > 0) {
+		p50 = (double)sorted[(count - 1) * 50 / 100] / 1e6;
+		p95 = (double)sorted[(count - 1) * 95 / 100] / 1e6;
+		p99 = (double)sorted[(count - 1) * 99 / 100] / 1e6;
+		fps = sum > 0 ? (double)count * 1e9 / (double)sum : 0.0;
+	}
+
+	MemoryStats memory = GetMemoryStats();
+	Uint64 culled = stats->leaves_generated > stats->leaves_drawn
+	                    ? stats->leaves_generated - stats->leaves_drawn
+	                    : 0;
+
+	char lines[6][96];
+	snprintf(lines[0], sizeof(lines[0]), "%s, depth %d", stats->mode,
+	         stats->depth);
+	snprintf(lines[1], sizeof(lines[1]),
+	         "%.0f fps  p50 %.2f  p95 %.2f  p99 %.2f ms", fps, p50, p95, p99);
+	snprintf(lines[2], sizeof(lines[2]),
+	         "leaves %llu generated, %llu culled, %llu drawn",
+	         (unsigned long long)stats->leaves_generated,
+	         (unsigned long long)culled,
+	         (unsigned long long)stats->leaves_drawn);
+	snprintf(lines[3], sizeof(lines[3]), "%llu draw calls",
+	         (unsigned long long)stats->draw_calls);
+	snprintf(lines[4], sizeof(lines[4]),
+	         "cpu %.1f  gpu %.1f  resident %.1f MiB",
+	         (double)memory.cpu_total.live / (1024.0 * 1024.0),
+	         (double)memory.gpu_total.live / (1024.0 * 1024.0),
+	         (double)memory.rss / (1024.0 * 1024.0));
+	snprintf(lines[5], sizeof(lines[5]), "hud %.3f ms%s",
+	         (double)hud->peak_cost_ns / 1e6,
+	         hud->peak_cost_ns > HUD_BUDGET_NS ? ", over budget" : "");
+	hud->peak_cost_ns = 0;
+	int line_count = (int)(sizeof(lines) / sizeof(lines[0]));
+
+	int width = 0;
+	for (int i = 0; i < line_count; i++) {
+		int line_width = text_width(hud, lines[i]);
+		if (line_width > width) {
+			width = line_width;
+		}
+	}
+
+	// The panel first, so the text is blended over it
+	hud->vertex_count = 0;
+	add_quad(hud, (float)MARGIN, (float)MARGIN,
+	         (float)(3 * MARGIN + width),
+	         (float)(3 * MARGIN + line_count * hud->line_height), 0, 0,
+	         SOLID_SIZE, SOLID_SIZE, panel_color);
+	for (int i = 0; i < line_count; i++) {
+		add_text(hud, 2 * MARGIN, 2 * MARGIN + i * hud->line_height,
+		         lines[i]);
+	}
+
+	// Orphan the old contents rather than wait for the draws reading them
+	Uint64 buffer_bytes = sizeof(HUDVertex) * 6 * HUD_MAX_CHARS;
+	glBindBuffer(GL_ARRAY_BUFFER, hud->vbo);
+	glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)buffer_bytes, NULL,
+	             GL_DYNAMIC_DRAW);
+	glBufferSubData(GL_ARRAY_BUFFER, 0,
+	                (GLsizeiptr)(sizeof(HUDVertex) * hud->vertex_count),
+	                hud->vertices);
+}
+
+void UpdateHUD(HUD *hud, const HUDStats *stats) {
+	TraceBegin("update HUD");
+	Uint64 start = SDL_GetTicksNS();
+
+	if (hud->last_frame != 0) {
+		hud->frame_ns[hud->frames % HUD_FRAME_HISTORY] =
+		    start - hud->last_frame;
+		hud->frames++;
+	}
+	hud->last_frame = start;
+
+	if (SDL_GetTicks() - hud->last_refresh >= HUD_REFRESH_MS) {
+		rebuild_text(hud, stats);
+		hud->last_refresh = SDL_GetTicks();
+	}
+
+	hud->cost_ns = SDL_GetTicksNS() - start;
+	TraceEnd("update HUD");
+}
+
+void DrawHUD(HUD *hud) {
+	if (hud->program == NULL || hud->vertex_count == 0) {
+		return;
+	}
+	Uint64 start = SDL_GetTicksNS();
+
+	GLint previous_program, previous_vao;
+	glGetIntegerv(GL_CURRENT_PROGRAM, &previous_program);
+	glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &previous_vao);
+
+	UseShaderProgram(hud->program);
+	glUniform2f(hud->screen_uniform, (float)hud->width, (float)hud->height);
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, hud->atlas);
+
+	glDisable(GL_DEPTH_TEST);
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	glBindVertexArray(hud->vao);
+	glDrawArrays(GL_TRIANGLES, 0, hud->vertex_count);
+	glDisable(GL_BLEND);
+	glEnable(GL_DEPTH_TEST);
+
+	glBindVertexArray(previous_vao);
+	glUseProgram(previous_program);
+
+	hud->cost_ns += SDL_GetTicksNS() - start;
+	if (hud->cost_ns > hud->peak_cost_ns) {
+		hud->peak_cost_ns = hud->cost_ns;
+	}
+}
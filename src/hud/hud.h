@@ -0,0 +1,109 @@
+#ifndef HUD_H
+#define HUD_H
+
+#include <SDL3/SDL.h>
+
+#include "shaders/shader.h"
+
+// Font size of the HUD text in points
+#define HUD_FONT_SIZE 14.0f
+
+// Most characters on screen at once, background included
+#define HUD_MAX_CHARS 1024
+
+// Frames the frame time percentiles are taken over
+#define HUD_FRAME_HISTORY 256
+
+// How often the text is rebuilt, it is drawn from the same buffer in between
+#define HUD_REFRESH_MS 250
+
+// The HUD's own CPU time per frame it should stay under
+#define HUD_BUDGET_NS 200000
+
+// Printable ASCII, the characters in the atlas
+#define HUD_FIRST_GLYPH 32
+#define HUD_GLYPH_COUNT 95
+
+// Where a glyph is in the atlas, in texels
+typedef struct HUDGlyph {
+	int x;
+	int y;
+	int width;
+	int height;
+	int advance;
+} HUDGlyph;
+
+// A corner of a glyph quad, in window pixels with y down
+typedef struct HUDVertex {
+	float x;
+	float y;
+	float u; // In the atlas, 0-1
+	float v;
+	Uint8 color[4];
+} HUDVertex;
+
+// What the frame drew, filled in by the caller every frame
+typedef struct HUDStats {
+	const char *mode;
+	int depth;
+	Uint64 leaves_generated;
+	Uint64 leaves_drawn; // The rest were culled
+	Uint64 draw_calls;
+} HUDStats;
+
+/**
+ * On-screen statistics: FPS, frame time percentiles, the depth, leaves
+ * generated, culled and drawn, draw calls and memory.
+ *
+ * The printable ASCII glyphs are rendered once with SDL_ttf into a single
+ * channel atlas texture, and the font is closed again. The text is laid out
+ * into a vertex buffer of quads every HUD_REFRESH_MS, and every frame draws
+ * the whole buffer (background panel included) with one glDrawArrays.
+ */
+typedef struct HUD {
+	int width; // Of the window, in pixels
+	int height;
+
+	HUDGlyph glyphs[HUD_GLYPH_COUNT];
+	int line_height;
+	int atlas_width;
+	int atlas_height;
+
+	unsigned int atlas; // GL_R8 coverage
+	unsigned int vao;
+	unsigned int vbo;
+	ShaderProgram *program;
+	int screen_uniform;
+
+	HUDVertex *vertices; // 6 per character, HUD_MAX_CHARS of them
+	int vertex_count;
+
+	Uint64 frame_ns[HUD_FRAME_HISTORY]; // Ring of the latest frame times
+	Uint64 frames;
+	Uint64 last_frame;
+	Uint64 last_refresh;
+
+	Uint64 cost_ns;      // CPU time of the latest UpdateHUD and DrawHUD
+	Uint64 peak_cost_ns; // Most of it in a frame since the text was rebuilt
+} HUD;
+
+/**
+ * Build the glyph atlas from the font at SIERPINSKI_HUD_FONT, or the first
+ * common monospace system font found, for a `width` by `height` window.
+ * Returns NULL if no font could be opened.
+ */
+HUD *CreateHUD(int width, int height);
+
+// Delete a HUD and its GL objects.
+void DestroyHUD(HUD *hud);
+
+/**
+ * Count a frame, and rebuild the text from `stats` if it is older than
+ * HUD_REFRESH_MS. Call once per frame.
+ */
+void UpdateHUD(HUD *hud, const HUDStats *stats);
+
+// Draw the text over the frame, in one draw call.
+void DrawHUD(HUD *hud);
+
+#endif // HUD_H
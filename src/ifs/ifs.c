@@ -0,0 +1,308 @@
+#include "ifs/ifs.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "baked_leaves.h"
+#include "cull/cull.h"
+#include "memory/memory.h"
+#include "trace/trace.h"
+#include "vertices.h"
+
+// Leaves generated per fractal by BenchmarkIFS, roughly
+#define BENCHMARK_LEAVES (1 << 21)
+
+// Generation and culling passes timed per fractal by BenchmarkIFS
+#define BENCHMARK_PASSES 5
+
+#define VERTEX_COUNT(vertices) ((int)(sizeof(vertices) / (sizeof(float) * 6)))
+
+static const float tetrahedron_offsets[4][3] = {
+    {0.5f, 0.5f, 0.5f},
+    {0.5f, -0.5f, -0.5f},
+    {-0.5f, 0.5f, -0.5f},
+    {-0.5f, -0.5f, 0.5f},
+};
+
+static const float menger_offsets[20][3] = {
+    {-1, -1, -1}, {-1, -1, 0}, {-1, -1, 1}, {-1, 0, -1}, {-1, 0, 1},
+    {-1, 1, -1},  {-1, 1, 0},  {-1, 1, 1},  {0, -1, -1}, {0, -1, 1},
+    {0, 1, -1},   {0, 1, 1},   {1, -1, -1}, {1, -1, 0},  {1, -1, 1},
+    {1, 0, -1},   {1, 0, 1},   {1, 1, -1},  {1, 1, 0},   {1, 1, 1},
+};
+
+static const float vicsek_offsets[7][3] = {
+    {0, 0, 0},  {-1, 0, 0}, {1, 0, 0},  {0, -1, 0},
+    {0, 1, 0},  {0, 0, -1}, {0, 0, 1},
+};
+
+static const float cantor_offsets[8][3] = {
+    {-1, -1, -1}, {-1, -1, 1}, {-1, 1, -1}, {-1, 1, 1},
+    {1, -1, -1},  {1, -1, 1},  {1, 1, -1},  {1, 1, 1},
+};
+
+const IFS ifs_sierpinski_pyramid = {
+    "sierpinski pyramid", 5, 0.5f, leaf_child_offsets,
+    triangle, VERTEX_COUNT(triangle), LeafChildOrder};
+
+const IFS ifs_sierpinski_tetrahedron = {
+    "sierpinski tetrahedron", 4, 0.5f, tetrahedron_offsets,
+    tetrahedron, VERTEX_COUNT(tetrahedron), NULL};
+
+const IFS ifs_menger_sponge = {
+    "menger sponge", 20, 1.0f / 3.0f, menger_offsets,
+    cube, VERTEX_COUNT(cube), NULL};
+
+const IFS ifs_vicsek = {
+    "vicsek", 7, 1.0f / 3.0f, vicsek_offsets,
+    cube, VERTEX_COUNT(cube), NULL};
+
+const IFS ifs_cantor_dust = {
+    "cantor dust", 8, 1.0f / 3.0f, cantor_offsets,
+    cube, VERTEX_COUNT(cube), NULL};
+
+const IFS *const ifs_list[IFS_COUNT] = {
+    &ifs_sierpinski_pyramid, &ifs_sierpinski_tetrahedron, &ifs_menger_sponge,
+    &ifs_vicsek, &ifs_cantor_dust};
+
+/**
+ * Expand one level of `parents` leaves in place into their `maps` children
+ * of scale `scale`. Walking the parents backwards means the children of
+ * parent `i` (written to maps*i onwards) never overwrite a parent that
+ * hasn't been expanded yet.
+ */
+#define EXPAND_LEVEL(maps)                                                     \
+	for (Uint64 i = parents; i-- > 0;) {                                       \
+		Leaf parent = leaves[i];                                               \
+		Leaf *children = &leaves[i * (maps)];                                  \
+		for (int c = 0; c < (maps); c++) {                                     \
+			children[c].center[0] = parent.center[0] + offsets[c][0] * scale;  \
+			children[c].center[1] = parent.center[1] + offsets[c][1] * scale;  \
+			children[c].center[2] = parent.center[2] + offsets[c][2] * scale;  \
+			children[c].scale = scale;                                         \
+		}                                                                      \
+	}
+
+typedef void (*ExpandKernel)(Leaf *leaves, Uint64 parents, float scale,
+                             const float (*offsets)[3], int maps);
+
+/**
+ * Define expand_<N>, the kernel for IFSs with N maps. With N a constant the
+ * child loop is unrolled and every offset is at a fixed index, which is what
+ * a hand-written kernel for one fractal would do.
+ */
+#define DEFINE_EXPAND_KERNEL(N)                                                \
+	static void expand_##N(Leaf *leaves, Uint64 parents, float scale,          \
+	                       const float (*offsets)[3], int maps) {              \
+		(void)maps;                                                            \
+		EXPAND_LEVEL(N)                                                        \
+	}
+
+DEFINE_EXPAND_KERNEL(4)
+DEFINE_EXPAND_KERNEL(5)
+DEFINE_EXPAND_KERNEL(7)
+DEFINE_EXPAND_KERNEL(8)
+DEFINE_EXPAND_KERNEL(20)
+
+// Kernel for any number of maps, read at run time.
+static void expand_generic(Leaf *leaves, Uint64 parents, float scale,
+                           const float (*offsets)[3], int maps) {
+	EXPAND_LEVEL(maps)
+}
+
+// The kernel specialized for `maps`, or the generic one if there isn't one.
+static ExpandKernel expand_kernel(int maps) {
+	switch (maps) {
+	case 4:
+		return expand_4;
+	case 5:
+		return expand_5;
+	case 7:
+		return expand_7;
+	case 8:
+		return expand_8;
+	case 20:
+		return expand_20;
+	default:
+		return expand_generic;
+	}
+}
+
+Uint64 IFSLeafCount(const IFS *ifs, int depth) {
+	Uint64 count = 1;
+	for (int i = 0; i < depth; i++) {
+		count *= ifs->map_count;
+	}
+	return count;
+}
+
+// Generate the leaves of `ifs` with `kernel`.
+static LeafBuffer *generate(const IFS *ifs, int depth, ExpandKernel kernel) {
+	LeafBuffer *buffer =
+	    (LeafBuffer *)TaggedMalloc(MEMORY_LEAVES, sizeof(LeafBuffer));
+	if (buffer == NULL) {
+		perror("Could not allocate memory for leaf buffer");
+		return NULL;
+	}
+
+	buffer->ifs = ifs;
+	buffer->depth = depth;
+	buffer->layout = LEAF_LAYOUT_TRAVERSAL;
+	buffer->count = IFSLeafCount(ifs, depth);
+	buffer->baked = false;
+	buffer->leaves =
+	    (Leaf *)TaggedMalloc(MEMORY_LEAVES, sizeof(Leaf) * buffer->count);
+	if (buffer->leaves == NULL) {
+		perror("Could not allocate memory for leaves");
+		TaggedFree(buffer);
+		return NULL;
+	}
+
+	Leaf *leaves = buffer->leaves;
+	leaves[0] = (Leaf){{0.0f, 0.0f, 0.0f}, 1.0f};
+
+	// Expand one level at a time, in place
+	Uint64 parents = 1;
+	for (int level = 0; level < depth; level++) {
+		float scale = leaves[0].scale * ifs->ratio;
+		kernel(leaves, parents, scale, ifs->offsets, ifs->map_count);
+		parents *= ifs->map_count;
+	}
+
+	return buffer;
+}
+
+LeafBuffer *CreateIFSLeafBuffer(const IFS *ifs, int depth) {
+	if (ifs != &ifs_sierpinski_pyramid || depth > BAKED_LEAF_MAX_DEPTH) {
+		TraceBegin("generate leaves");
+		LeafBuffer *buffer =
+		    generate(ifs, depth, expand_kernel(ifs->map_count));
+		TraceEnd("generate leaves");
+		return buffer;
+	}
+
+	LeafBuffer *buffer =
+	    (LeafBuffer *)TaggedMalloc(MEMORY_LEAVES, sizeof(LeafBuffer));
+	if (buffer == NULL) {
+		perror("Could not allocate memory for leaf buffer");
+		return NULL;
+	}
+
+	buffer->ifs = ifs;
+	buffer->depth = depth;
+	buffer->layout = LEAF_LAYOUT_TRAVERSAL;
+	buffer->count = IFSLeafCount(ifs, depth);
+	buffer->leaves = (Leaf *)baked_leaves[depth];
+	buffer->baked = true;
+	return buffer;
+}
+
+bool VerifyBakedLeaves(void) {
+	const IFS *ifs = &ifs_sierpinski_pyramid;
+	bool matches = true;
+
+	for (int depth = 0; depth <= BAKED_LEAF_MAX_DEPTH; depth++) {
+		LeafBuffer *generated =
+		    generate(ifs, depth, expand_kernel(ifs->map_count));
+		if (generated == NULL) {
+			return false;
+		}
+
+		if (memcmp(generated->leaves, baked_leaves[depth],
+		           sizeof(Leaf) * generated->count) != 0) {
+			printf("Baked leaves at depth %d don't match the generator\n",
+			       depth);
+			matches = false;
+		}
+		DestroyLeafBuffer(generated);
+	}
+
+	return matches;
+}
+
+const int *IFSChildOrder(const IFS *ifs, const float center[3], float scale,
+                         const float eye[3], int scratch[IFS_MAX_MAPS]) {
+	if (ifs->child_order != NULL) {
+		return ifs->child_order(center, eye);
+	}
+
+	// Insertion sort of the children by squared distance to the eye
+	float distances[IFS_MAX_MAPS];
+	float child_scale = ifs->ratio * scale;
+	for (int c = 0; c < ifs->map_count; c++) {
+		float distance = 0.0f;
+		for (int i = 0; i < 3; i++) {
+			float d =
+			    center[i] + ifs->offsets[c][i] * child_scale - eye[i];
+			distance += d * d;
+		}
+
+		int j = c;
+		for (; j > 0 && distances[j - 1] > distance; j--) {
+			distances[j] = distances[j - 1];
+			scratch[j] = scratch[j - 1];
+		}
+		distances[j] = distance;
+		scratch[j] = c;
+	}
+	return scratch;
+}
+
+// Average time of `BENCHMARK_PASSES` generations with `kernel`, in ms.
+static double time_generation(const IFS *ifs, int depth, ExpandKernel kernel) {
+	Uint64 elapsed = 0;
+	for (int i = 0; i < BENCHMARK_PASSES; i++) {
+		Uint64 start = SDL_GetTicksNS();
+		LeafBuffer *buffer = generate(ifs, depth, kernel);
+		elapsed += SDL_GetTicksNS() - start;
+		if (buffer == NULL) {
+			return 0.0;
+		}
+		DestroyLeafBuffer(buffer);
+	}
+	return (double)elapsed / 1e6 / BENCHMARK_PASSES;
+}
+
+void BenchmarkIFS(mat4 view_proj) {
+	VisibleRanges *visible = CreateVisibleRanges(NULL);
+	if (visible == NULL) {
+		return;
+	}
+
+	printf("IFS benchmark, about %d leaves each (%d passes)\n",
+	       BENCHMARK_LEAVES, BENCHMARK_PASSES);
+	printf("%24s %5s %6s %10s %11s %15s %8s %9s %10s\n", "fractal", "maps",
+	       "depth", "leaves", "generic ms", "specialized ms", "speedup",
+	       "cull ms", "visible");
+
+	for (int f = 0; f < IFS_COUNT; f++) {
+		const IFS *ifs = ifs_list[f];
+
+		int depth = 0;
+		while (IFSLeafCount(ifs, depth + 1) <= BENCHMARK_LEAVES) {
+			depth++;
+		}
+
+		double generic_ms = time_generation(ifs, depth, expand_generic);
+		double specialized_ms =
+		    time_generation(ifs, depth, expand_kernel(ifs->map_count));
+
+		Uint64 start = SDL_GetTicksNS();
+		for (int i = 0; i < BENCHMARK_PASSES; i++) {
+			CullLeafRanges(visible, ifs, view_proj, NULL, depth,
+			               CULL_DEFAULT_MAX_LEVEL);
+		}
+		double cull_ms =
+		    (double)(SDL_GetTicksNS() - start) / 1e6 / BENCHMARK_PASSES;
+
+		printf("%24s %5d %6d %10llu %11.3f %15.3f %7.2fx %9.3f %10llu\n",
+		       ifs->name, ifs->map_count, depth,
+		       (unsigned long long)IFSLeafCount(ifs, depth), generic_ms,
+		       specialized_ms,
+		       specialized_ms > 0.0 ? generic_ms / specialized_ms : 0.0,
+		       cull_ms, (unsigned long long)visible->leaves);
+	}
+
+	DestroyVisibleRanges(visible);
+}
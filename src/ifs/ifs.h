@@ -0,0 +1,90 @@
+#ifndef IFS_H
+#define IFS_H
+
+#include <SDL3/SDL.h>
+#include <cglm/cglm.h>
+
+#include "leaves/leaves.h"
+
+// Most maps an IFS can have, the size of the child order scratch arrays.
+#define IFS_MAX_MAPS 27
+
+/**
+ * An iterated function system of `map_count` similarity maps.
+ *
+ * Every map scales by the same `ratio` and then translates. A node of scale
+ * `s` centered at `c` has a child of scale `ratio * s` centered at
+ * `c + offsets[i] * ratio * s` for every map `i`. A leaf record (a center and
+ * a uniform scale) and the instanced shaders can represent exactly these.
+ *
+ * The attractor has to fit in the unit cube around the origin. Then a
+ * node's box, `center` +- `scale` / 2, bounds its whole subtree, which is
+ * what culling relies on. `base_vertices` is the primitive drawn at every
+ * leaf, in the `vertices.h` layout, and fits in the same cube.
+ */
+typedef struct IFS {
+	const char *name;
+	int map_count;
+	float ratio;
+	const float (*offsets)[3];
+
+	const float *base_vertices;
+	int base_vertex_count;
+
+	// Front-to-back child order as seen from `eye`. If NULL, IFSChildOrder
+	// sorts the children by distance instead.
+	const int *(*child_order)(const float center[3], const float eye[3]);
+} IFS;
+
+// The pyramid this app was written for: 5 maps of ratio 1/2.
+extern const IFS ifs_sierpinski_pyramid;
+// 4 maps of ratio 1/2 towards the corners of a tetrahedron.
+extern const IFS ifs_sierpinski_tetrahedron;
+// 20 maps of ratio 1/3: the cube minus its face and body centers.
+extern const IFS ifs_menger_sponge;
+// 7 maps of ratio 1/3: the center cube and its face neighbours.
+extern const IFS ifs_vicsek;
+// 8 maps of ratio 1/3 towards the corners of the cube.
+extern const IFS ifs_cantor_dust;
+
+// Every built-in IFS, in the order the G key cycles through them.
+#define IFS_COUNT 5
+extern const IFS *const ifs_list[IFS_COUNT];
+
+// Number of leaves of `ifs` at a depth (map_count^depth).
+Uint64 IFSLeafCount(const IFS *ifs, int depth);
+
+/**
+ * Generate every leaf of `ifs` subdivided `depth` times, starting from a
+ * unit node at the origin.
+ *
+ * Leaves are in base-`map_count` traversal order, like the pyramid's (see
+ * leaves.h). Built-in map counts have their own unrolled expansion kernel.
+ *
+ * The pyramid up to BAKED_LEAF_MAX_DEPTH isn't generated at all: the buffer
+ * points at tables generated at build time by tools/bake_leaves.c.
+ */
+LeafBuffer *CreateIFSLeafBuffer(const IFS *ifs, int depth);
+
+/**
+ * Check that the baked pyramid leaves are bit-for-bit what the generator
+ * produces. Prints the depths that differ. Run by `make verify-leaves`.
+ */
+bool VerifyBakedLeaves(void);
+
+/**
+ * Front-to-back order of the children of a node of `ifs` centered at
+ * `center`, with scale `scale`, as seen from `eye`. Uses `child_order` if
+ * the IFS has one, otherwise sorts the children by distance into `scratch`.
+ */
+const int *IFSChildOrder(const IFS *ifs, const float center[3], float scale,
+                         const float eye[3], int scratch[IFS_MAX_MAPS]);
+
+/**
+ * For every built-in IFS at a depth of about 2 million leaves, time leaf
+ * generation with the generic and the specialized kernel, and culling
+ * against `view_proj`.
+ */
+void BenchmarkIFS(mat4 view_proj);
+
+#endif // IFS_H
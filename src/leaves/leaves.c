@@ -0,0 +1,155 @@
+#include "leaves/leaves.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ifs/ifs.h"
+#include "memory/memory.h"
+
+const float leaf_child_offsets[5][3] = {
+    {0.0f, 0.5f, 0.0f},    // top
+    {-0.5f, -0.5f, 0.5f},  // left_front
+    {-0.5f, -0.5f, -0.5f}, // left_back
+    {0.5f, -0.5f, 0.5f},   // right_front
+    {0.5f, -0.5f, -0.5f},  // right_back
+};
+
+// Child visit orders indexed by octant: bit 0 set when the camera is at +x
+// of the center, bit 1 when above it, bit 2 when at +z.
+static const int child_orders[8][5] = {
+    {2, 1, 4, 3, 0}, // -x, below, -z
+    {4, 3, 2, 1, 0}, // +x, below, -z
+    {0, 2, 1, 4, 3}, // -x, above, -z
+    {0, 4, 3, 2, 1}, // +x, above, -z
+    {1, 2, 3, 4, 0}, // -x, below, +z
+    {3, 4, 1, 2, 0}, // +x, below, +z
+    {0, 1, 2, 3, 4}, // -x, above, +z
+    {0, 3, 4, 1, 2}, // +x, above, +z
+};
+
+const int *LeafChildOrder(const float center[3], const float eye[3]) {
+	int octant = (eye[0] > center[0]) | ((eye[1] > center[1]) << 1) |
+	             ((eye[2] > center[2]) << 2);
+	return child_orders[octant];
+}
+
+Uint64 LeafCount(int depth) {
+	Uint64 count = 1;
+	for (int i = 0; i < depth; i++) {
+		count *= 5;
+	}
+	return count;
+}
+
+LeafBuffer *CreateLeafBuffer(int depth) {
+	return CreateIFSLeafBuffer(&ifs_sierpinski_pyramid, depth);
+}
+
+// Spread the low 21 bits of `x` out to every third bit.
+static Uint64 spread_bits(Uint64 x) {
+	x &= 0x1fffff;
+	x = (x | x << 32) & 0x1f00000000ffffULL;
+	x = (x | x << 16) & 0x1f0000ff0000ffULL;
+	x = (x | x << 8) & 0x100f00f00f00f00fULL;
+	x = (x | x << 4) & 0x10c30c30c30c30c3ULL;
+	x = (x | x << 2) & 0x1249249249249249ULL;
+	return x;
+}
+
+Uint64 LeafMortonCode(const Leaf *leaf, int depth) {
+	// Centers are in (-0.5, 0.5), shifting and scaling by a power of two
+	// is exact.
+	float lattice = (float)(1 << (depth + 1));
+	Uint64 x = (Uint64)((leaf->center[0] + 0.5f) * lattice);
+	Uint64 y = (Uint64)((leaf->center[1] + 0.5f) * lattice);
+	Uint64 z = (Uint64)((leaf->center[2] + 0.5f) * lattice);
+	return spread_bits(x) | spread_bits(y) << 1 | spread_bits(z) << 2;
+}
+
+void SortLeavesMorton(LeafBuffer *buffer) {
+	if (buffer->layout == LEAF_LAYOUT_MORTON || buffer->count < 2) {
+		buffer->layout = LEAF_LAYOUT_MORTON;
+		return;
+	}
+
+	Uint64 count = buffer->count;
+	Uint64 *keys =
+	    (Uint64 *)TaggedMalloc(MEMORY_LEAVES, sizeof(Uint64) * count * 2);
+	Leaf *scratch = (Leaf *)TaggedMalloc(MEMORY_LEAVES, sizeof(Leaf) * count);
+	if (keys == NULL || scratch == NULL) {
+		perror("Could not allocate memory to sort leaves");
+		TaggedFree(keys);
+		TaggedFree(scratch);
+		return;
+	}
+
+	// The sort writes back into the leaves, which a baked table can't take
+	if (buffer->baked) {
+		Leaf *copy = (Leaf *)TaggedMalloc(MEMORY_LEAVES, sizeof(Leaf) * count);
+		if (copy == NULL) {
+			perror("Could not allocate memory to sort leaves");
+			TaggedFree(keys);
+			TaggedFree(scratch);
+			return;
+		}
+		memcpy(copy, buffer->leaves, sizeof(Leaf) * count);
+		buffer->leaves = copy;
+		buffer->baked = false;
+	}
+
+	for (Uint64 i = 0; i < count; i++) {
+		keys[i] = LeafMortonCode(&buffer->leaves[i], buffer->depth);
+	}
+
+	// LSD radix sort, 8 bits per pass, over the 3 * (depth + 1) key bits
+	Uint64 *key_in = keys, *key_out = keys + count;
+	Leaf *leaf_in = buffer->leaves, *leaf_out = scratch;
+	int bits = 3 * (buffer->depth + 1);
+
+	for (int shift = 0; shift < bits; shift += 8) {
+		Uint64 offsets[256] = {0};
+		for (Uint64 i = 0; i < count; i++) {
+			offsets[(key_in[i] >> shift) & 0xff]++;
+		}
+		Uint64 total = 0;
+		for (int b = 0; b < 256; b++) {
+			Uint64 n = offsets[b];
+			offsets[b] = total;
+			total += n;
+		}
+		for (Uint64 i = 0; i < count; i++) {
+			Uint64 dest = offsets[(key_in[i] >> shift) & 0xff]++;
+			key_out[dest] = key_in[i];
+			leaf_out[dest] = leaf_in[i];
+		}
+
+		Uint64 *key_tmp = key_in;
+		key_in = key_out;
+		key_out = key_tmp;
+		Leaf *leaf_tmp = leaf_in;
+		leaf_in = leaf_out;
+		leaf_out = leaf_tmp;
+	}
+
+	// Keep whichever array ended up holding the sorted leaves
+	if (leaf_in != buffer->leaves) {
+		if (!buffer->baked) {
+			TaggedFree(buffer->leaves);
+		}
+		buffer->leaves = leaf_in;
+		buffer->baked = false;
+	} else {
+		TaggedFree(scratch);
+	}
+	TaggedFree(keys);
+
+	buffer->layout = LEAF_LAYOUT_MORTON;
+}
+
+void DestroyLeafBuffer(LeafBuffer *buffer) {
+	if (!buffer->baked) {
+		TaggedFree(buffer->leaves);
+	}
+	TaggedFree(buffer);
+}
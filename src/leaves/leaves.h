@@ -0,0 +1,90 @@
+#ifndef LEAVES_H
+#define LEAVES_H
+
+#include <SDL3/SDL.h>
+
+/**
+ * A single pyramid of the subdivided fractal.
+ *
+ * The base pyramid in `vertices.h` is drawn at `center` and uniformly scaled
+ * by `scale`, i.e. each vertex is transformed as `coord * scale + center`.
+ * This is laid out to be uploaded directly as a vec4 instance attribute.
+ */
+typedef struct Leaf {
+	float center[3];
+	float scale;
+} Leaf;
+
+// Order of the leaves in a LeafBuffer
+typedef enum LeafLayout {
+	LEAF_LAYOUT_TRAVERSAL, // Base-5 traversal order, subtrees are contiguous
+	LEAF_LAYOUT_MORTON,    // Z-order of the leaves' lattice coordinates
+} LeafLayout;
+
+/**
+ * All the leaves of the fractal at a given subdivision depth.
+ *
+ * Unless `layout` says otherwise, leaves are stored in base-5 traversal
+ * order, the same order `draw_serpinskis_triangle` visits them in (top,
+ * left_front, left_back, right_front, right_back). Digit `i` of a leaf's
+ * index in base 5 picks the child taken at level `i` (most significant digit
+ * first), so every subtree occupies a contiguous range of leaves.
+ */
+typedef struct LeafBuffer {
+	const struct IFS *ifs; // The fractal the leaves belong to, see ifs.h
+	int depth;
+	LeafLayout layout;
+	Uint64 count;
+	Leaf *leaves;
+	bool baked; // `leaves` points at a read-only table built into the binary
+} LeafBuffer;
+
+// Offsets from a pyramid's center to its children's centers, in units of the
+// child's scale, in traversal order.
+extern const float leaf_child_offsets[5][3];
+
+/**
+ * Front-to-back order to visit the children of a pyramid centered at
+ * `center` when looking from `eye`, picked from the octant `eye` is in.
+ *
+ * The bottom child in the camera's quadrant comes first and the opposite
+ * one last. The top child goes first when the camera is above the center
+ * and last when it is below. Returns five child indices (see
+ * `leaf_child_offsets`).
+ */
+const int *LeafChildOrder(const float center[3], const float eye[3]);
+
+// Number of leaves at a subdivision depth (5^depth).
+Uint64 LeafCount(int depth);
+
+/**
+ * Generate every leaf of the fractal subdivided `depth` times, starting from
+ * the unit pyramid centered at the origin (the one `draw_serpinskis_triangle`
+ * draws with its top at (0, 0.5, 0) and a scale of 1).
+ *
+ * Same as CreateIFSLeafBuffer with `ifs_sierpinski_pyramid`.
+ */
+LeafBuffer *CreateLeafBuffer(int depth);
+
+/**
+ * Morton code of a leaf of a `depth` deep pyramid.
+ *
+ * Leaf centers lie on a lattice with a spacing of 2^-(depth + 1), so each
+ * coordinate maps exactly to an integer below 2^(depth + 1). Interleaving
+ * their bits gives the Z-order curve index. Valid up to a depth of 20.
+ */
+Uint64 LeafMortonCode(const Leaf *leaf, int depth);
+
+/**
+ * Reorder the leaves along the Morton curve, so leaves that are close in
+ * space are close in memory. Baked leaves are copied first.
+ *
+ * Subtrees are no longer contiguous afterwards, so the buffer can't be used
+ * with the subtree ranges from cull.h.
+ */
+void SortLeavesMorton(LeafBuffer *buffer);
+
+// Free a leaf buffer.
+void DestroyLeafBuffer(LeafBuffer *buffer);
+
+#endif // LEAVES_H
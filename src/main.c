@@ -3,10 +3,25 @@
 #include <cglm/cglm.h>
 #include <glad/glad.h>
 
+#include "arena/arena.h"
+#include "blocks/blocks.h"
 #include "camera/camera.h"
 #include "clock/clock.h"
+#include "cull/cull.h"
+#include "glext/glext.h"
+#include "glstats/glstats.h"
+#include "governor/governor.h"
+#include "hud/hud.h"
+#include "ifs/ifs.h"
+#include "leaves/leaves.h"
+#include "memory/memory.h"
+#include "overdraw/overdraw.h"
+#include "query/query.h"
+#include "recursive/recursive.h"
 #include "shaders/shader.h"
-#include "vertices.h"
+#include "splat/splat.h"
+#include "timing/timing.h"
+#include "trace/trace.h"
 
 // Used to handle joystick drifting. (My controller suffers terribly with it
 // >~< )
@@ -20,76 +35,57 @@ const float ROTATION_SPEED = 10.0f;
 void handle_mouse(void *user_data, Uint64 timestamp, SDL_Window *window,
                   SDL_MouseID mouse_id, float *x, float *y);
 
-// Used to draw a traingle.
-void draw_triangle(vec3 top, float scale, unsigned int uniform_loc);
-
-/**
- * Draw Serpinski's traingle.
- *
- * `top`, `bottom_left`, `bottom_right` are the coordinates of the triangle to
- * draw.
- *
- * `subdivide` indicates whether the traingle should be divided using recursion.
- *
- * `uniform_loc` is the location of the transform's uniform in the shader
- * program.
- *
- * Note: this assumes the correct shader program has been loaded and the
- * uniforms have been setup properly.
- */
-void draw_serpinskis_triangle(vec3 top, int subdivide, float scale,
-                              unsigned int uniform_loc);
-
 int main(int argc, char *argv[]) {
 	(void)argc;
 	(void)argv;
 	SDL_Init(SDL_INIT_VIDEO | SDL_INIT_GAMEPAD);
 
-	// Define OpenGL aatributes for SDL
+	// Capture from the start (e.g. to see shader loading) if asked to
+	TraceThreadName("main");
+	if (SDL_getenv("SIERPINSKI_TRACE") != NULL) {
+		StartTrace();
+	}
+
+	// Define OpenGL aatributes for SDL. A 4.3 context is asked for first so
+	// the optional paths (e.g. multi-draw indirect) are available.
 	SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER, 1);
-	SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 3);
+	SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 4);
 	SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 3);
 	SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK,
 	                    SDL_GL_CONTEXT_PROFILE_CORE);
 
+	// GL call counting, with a debug context so the driver reports
+	// performance warnings
+	bool gl_stats = SDL_getenv("SIERPINSKI_GL_STATS") != NULL;
+	if (gl_stats) {
+		SDL_GL_SetAttribute(SDL_GL_CONTEXT_FLAGS, SDL_GL_CONTEXT_DEBUG_FLAG);
+	}
+
 	// Setup the window and GL context
 
 	SDL_Window *window =
 	    SDL_CreateWindow("Sierpinski's Triangle", 800, 800, SDL_WINDOW_OPENGL);
 
 	SDL_GLContext context = SDL_GL_CreateContext(window);
+	if (context == NULL) {
+		// Fall back to the 3.3 core profile everything else is written for
+		SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 3);
+		SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 3);
+		context = SDL_GL_CreateContext(window);
+	}
 	gladLoadGLLoader((GLADloadproc)SDL_GL_GetProcAddress);
+	LoadGLExtensions();
+	if (gl_stats) {
+		EnableGLStats();
+	}
 	glViewport(0, 0, 800, 800);
 	glEnable(GL_DEPTH_TEST);
 
-	// Copy the vertex data to the GPU for OpenGL
-
-	unsigned int vbo, vao;
-	glGenBuffers(1, &vbo);
-	glBindBuffer(GL_ARRAY_BUFFER, vbo);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(triangle), triangle, GL_STATIC_DRAW);
-
-	glGenVertexArrays(1, &vao);
-	glBindVertexArray(vao);
-
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(float) * 6,
-	                      (void *)0);
-	glEnableVertexAttribArray(0);
-	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(float) * 6,
-	                      (void *)(sizeof(float) * 3));
-	glEnableVertexAttribArray(1);
-
-	// Setup the shader program
-	ShaderProgram *program = LoadShaderProgram("shader.vert", "shader.frag");
-	UseShaderProgram(program);
-
-	mat4 transform = GLM_MAT4_IDENTITY_INIT;
-	glm_scale(transform, (vec3){0.5, 0.5, 0.0});
-
-	unsigned int model_uniform = glGetUniformLocation(*program, "model");
-	unsigned int view_uniform = glGetUniformLocation(*program, "view");
-	unsigned int perspective_uniform =
-	    glGetUniformLocation(*program, "perspective");
+	// The base pyramid and shaders of the recursive mode
+	RecursiveRenderer *recursive = CreateRecursiveRenderer();
+	if (recursive == NULL) {
+		return 1;
+	}
 
 	// Camera and clock setup
 
@@ -122,8 +118,63 @@ int main(int argc, char *argv[]) {
 
 	int subdivide = 0;
 
+	RenderMode render_mode = RENDER_RECURSIVE;
+
+	// Created the first time their mode is selected
+	Splatter *splatter = NULL;
+
+	// Scratch memory for data that only lives for one frame, reset at the top
+	// of the loop.
+	Arena *frame_arena = CreateArena("frame", FRAME_ARENA_SIZE);
+	if (frame_arena == NULL) {
+		return 1;
+	}
+
+	// Predicts the cost of deeper subdivisions and keeps them in budget
+	Governor *governor = CreateGovernor(800, 800);
+	if (governor == NULL) {
+		return 1;
+	}
+
+	// GPU time of the render passes, read back a few frames late
+	GPUTimer *gpu_timer = CreateGPUTimer();
+	if (gpu_timer == NULL) {
+		return 1;
+	}
+
+	// What the pipeline did in the fractal pass
+	PipelineStats *pipeline_stats = CreatePipelineStats();
+	if (pipeline_stats == NULL) {
+		return 1;
+	}
+
+	// Depth of the block baked for instanced mode, changed with [ and ].
+	int block_depth = 4;
+	BlockRenderer *block_renderer = NULL;
+
+	// Index in `ifs_list` of the fractal drawn in instanced mode, cycled with G
+	int ifs_index = 0;
+
+	// Overdraw heatmap instead of the fractal, toggled with H. Created the
+	// first time it is shown.
+	bool show_overdraw = false;
+	Overdraw *overdraw = NULL;
+
+	// Statistics drawn over the frame, toggled with F3. Created the first
+	// time it is shown.
+	bool show_hud = false;
+	HUD *hud = NULL;
+
+	// Draw front to back from the camera, toggled with F
+	bool front_to_back = false;
+	Uint64 last_title_update = 0;
+
 	bool running = true;
 	while (running) {
+		TraceBegin("frame");
+		ResetArena(frame_arena);
+
+		STAGE_BEGIN(STAGE_EVENTS);
 		SDL_Event event;
 		while (SDL_PollEvent(&event)) {
 			switch (event.type) {
@@ -142,12 +193,205 @@ int main(int argc, char *argv[]) {
 						subdivide = 0;
 					break;
 				case SDLK_UP:
-					subdivide++;
+					// May switch to a cheaper mode, or refuse the step
+					if (GovernDepth(governor, subdivide + 1, block_depth,
+					                &render_mode)) {
+						subdivide++;
+					}
 					break;
 
 				case SDLK_RETURN:
 					fov = 45.0f;
 					break;
+
+				case SDLK_M:
+					render_mode =
+					    (RenderMode)((render_mode + 1) % RENDER_MODE_COUNT);
+					printf("Render mode: %s\n",
+					       render_mode_names[render_mode]);
+					// Skip modes the current depth is too deep for
+					GovernDepth(governor, subdivide, block_depth, &render_mode);
+					break;
+
+				// Smaller blocks mean more instances, so the governor may
+				// refuse the change
+				case SDLK_LEFTBRACKET:
+					if (block_depth > 0 &&
+					    GovernDepth(governor, subdivide, block_depth - 1,
+					                &render_mode))
+						block_depth--;
+					printf("Block depth: %d\n", block_depth);
+					break;
+				case SDLK_RIGHTBRACKET:
+					if (block_depth < BLOCK_MAX_DEPTH &&
+					    GovernDepth(governor, subdivide, block_depth + 1,
+					                &render_mode))
+						block_depth++;
+					printf("Block depth: %d\n", block_depth);
+					break;
+
+				case SDLK_C:
+					if (block_renderer != NULL) {
+						block_renderer->cull = !block_renderer->cull;
+						printf("Culling: %s\n",
+						       block_renderer->cull ? "on" : "off");
+					}
+					break;
+
+				case SDLK_P:
+					if (block_renderer != NULL) {
+						block_renderer->pull = !block_renderer->pull;
+						printf("Vertex pulling: %s\n",
+						       block_renderer->pull ? "on" : "off");
+					}
+					break;
+
+				case SDLK_J:
+					if (block_renderer != NULL) {
+						SetBlockRendererMergeFaces(block_renderer,
+						                           !block_renderer->merge_faces);
+						printf("Face merging: %s\n",
+						       block_renderer->merge_faces ? "on" : "off");
+					}
+					break;
+
+				case SDLK_K:
+					if (render_mode == RENDER_INSTANCED &&
+					    block_renderer != NULL) {
+						mat4 view, perspective;
+						GetCameraViewMatrix(camera, view);
+						glm_perspective(glm_rad(fov), 1.0f, 0.1f, 100.0f,
+						                perspective);
+						BenchmarkFaceMerging(block_renderer, view, perspective);
+					}
+					break;
+
+				case SDLK_V:
+					if (render_mode == RENDER_INSTANCED &&
+					    block_renderer != NULL) {
+						mat4 view, perspective;
+						GetCameraViewMatrix(camera, view);
+						glm_perspective(glm_rad(fov), 1.0f, 0.1f, 100.0f,
+						                perspective);
+						BenchmarkVertexCache(block_renderer, view, perspective);
+					}
+					break;
+
+				case SDLK_R:
+					if (IsTracing()) {
+						if (WriteTrace(TRACE_FILE)) {
+							printf("Trace written to %s\n", TRACE_FILE);
+						}
+					} else {
+						StartTrace();
+						printf("Tracing, press R again to write %s\n",
+						       TRACE_FILE);
+					}
+					break;
+
+				case SDLK_T:
+					PrintStageTimings();
+					PrintPipelineStats(pipeline_stats);
+					PrintMemoryStats();
+					if (WriteStageTimings(STAGE_TIMINGS_CSV)) {
+						printf("Stage timings written to %s\n",
+						       STAGE_TIMINGS_CSV);
+					}
+					break;
+
+				case SDLK_H:
+					show_overdraw = !show_overdraw;
+					if (show_overdraw && overdraw == NULL) {
+						overdraw = CreateOverdraw(800, 800);
+					}
+					printf("Overdraw heatmap: %s\n",
+					       show_overdraw ? "on" : "off");
+					break;
+
+				case SDLK_N:
+					PrintGLStats();
+					break;
+
+				case SDLK_F3:
+					show_hud = !show_hud;
+					if (show_hud && hud == NULL) {
+						hud = CreateHUD(800, 800);
+					}
+					printf("HUD: %s\n", show_hud ? "on" : "off");
+					break;
+
+				case SDLK_F:
+					front_to_back = !front_to_back;
+					if (block_renderer != NULL) {
+						block_renderer->front_to_back = front_to_back;
+					}
+					printf("Front-to-back order: %s\n",
+					       front_to_back ? "on" : "off");
+					break;
+
+				case SDLK_O: {
+					mat4 view, perspective;
+					GetCameraViewMatrix(camera, view);
+					glm_perspective(glm_rad(fov), 1.0f, 0.1f, 100.0f,
+					                perspective);
+					if (render_mode == RENDER_INSTANCED &&
+					    block_renderer != NULL) {
+						BenchmarkDrawOrder(block_renderer, view, perspective);
+					} else if (render_mode == RENDER_RECURSIVE) {
+						UseRecursiveRenderer(recursive, view, perspective);
+						benchmark_draw_order(subdivide,
+						                     recursive->model_uniform,
+						                     camera->pos);
+					}
+					break;
+				}
+
+				case SDLK_B:
+					if (render_mode == RENDER_INSTANCED &&
+					    block_renderer != NULL) {
+						mat4 view, perspective;
+						GetCameraViewMatrix(camera, view);
+						glm_perspective(glm_rad(fov), 1.0f, 0.1f, 100.0f,
+						                perspective);
+						BenchmarkBlocks(block_renderer, view, perspective);
+					}
+					break;
+
+				case SDLK_L: {
+					mat4 view, perspective, view_proj;
+					GetCameraViewMatrix(camera, view);
+					glm_perspective(glm_rad(fov), 1.0f, 0.1f, 100.0f,
+					                perspective);
+					glm_mat4_mul(perspective, view, view_proj);
+					BenchmarkLeafLayouts(subdivide < LEAF_BENCHMARK_MAX_DEPTH
+					                         ? subdivide
+					                         : LEAF_BENCHMARK_MAX_DEPTH,
+					                     view_proj);
+					break;
+				}
+
+				case SDLK_G:
+					ifs_index = (ifs_index + 1) % IFS_COUNT;
+					governor->ifs = ifs_list[ifs_index];
+					printf("Fractal: %s\n", governor->ifs->name);
+					// Other fractals are only drawn instanced, and grow at a
+					// different rate, so the depth may have to come down.
+					while (!GovernDepth(governor, subdivide, block_depth,
+					                    &render_mode) &&
+					       subdivide > 0) {
+						subdivide--;
+					}
+					break;
+
+				case SDLK_I: {
+					mat4 view, perspective, view_proj;
+					GetCameraViewMatrix(camera, view);
+					glm_perspective(glm_rad(fov), 1.0f, 0.1f, 100.0f,
+					                perspective);
+					glm_mat4_mul(perspective, view, view_proj);
+					BenchmarkIFS(view_proj);
+					break;
+				}
 				}
 				break;
 
@@ -161,7 +405,9 @@ int main(int argc, char *argv[]) {
 				break;
 			}
 		}
+		STAGE_END(STAGE_EVENTS);
 
+		STAGE_BEGIN(STAGE_INPUT);
 		const bool *keys = SDL_GetKeyboardState(NULL);
 		vec3 direction = {0.0, 0.0, 0.0};
 
@@ -263,28 +509,219 @@ int main(int argc, char *argv[]) {
 
 		mat4 perspective;
 		glm_perspective(glm_rad(fov), 1.0f, 0.1f, 100.0f, perspective);
+		STAGE_END(STAGE_INPUT);
+
+		// The splatter and block renderer are created the first time their
+		// mode is selected, by M or by the governor. The splatter spawns a
+		// worker per core. If it can't be created, splat mode is dropped
+		// rather than retried every frame.
+		if (render_mode == RENDER_SPLAT && splatter == NULL &&
+		    !governor->unavailable[RENDER_SPLAT]) {
+			splatter = CreateSplatter(800, 800, SPLAT_DEFAULT_POINTS);
+			if (splatter == NULL) {
+				printf("Splat mode is unavailable\n");
+				governor->unavailable[RENDER_SPLAT] = true;
+				while (!GovernDepth(governor, subdivide, block_depth,
+				                    &render_mode) &&
+				       subdivide > 0) {
+					subdivide--;
+				}
+			}
+		} else if (render_mode == RENDER_INSTANCED && block_renderer == NULL) {
+			block_renderer = CreateBlockRenderer(frame_arena);
+			if (block_renderer != NULL) {
+				block_renderer->front_to_back = front_to_back;
+			}
+		}
 
-		glUniformMatrix4fv(view_uniform, 1, GL_FALSE, (float *)view);
-		glUniformMatrix4fv(perspective_uniform, 1, GL_FALSE,
-		                   (float *)perspective);
-
+		BeginGPUFrame(gpu_timer);
+		BeginGPUPass(gpu_timer, GPU_PASS_CLEAR);
 		glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+		EndGPUPass(gpu_timer, GPU_PASS_CLEAR);
+
+		// Only the time spent drawing the fractal is fed to the governor,
+		// not rebuilding the leaves or the mesh, nor the overlays.
+		Uint64 observed_ns = 0;
+		bool counting_overdraw = show_overdraw && overdraw != NULL;
+		BeginGPUPass(gpu_timer, GPU_PASS_FRACTAL);
+		BeginPipelineStats(pipeline_stats);
+		if (counting_overdraw) {
+			BeginOverdraw(overdraw);
+		}
+		switch (render_mode) {
+		case RENDER_SPLAT:
+			if (splatter != NULL) {
+				mat4 view_proj;
+				glm_mat4_mul(perspective, view, view_proj);
+				Uint64 splat_start = SDL_GetTicksNS();
+				STAGE_BEGIN(STAGE_GENERATE);
+				bool accumulated = UpdateSplatter(splatter, view_proj);
+				STAGE_END(STAGE_GENERATE);
+				STAGE_BEGIN(STAGE_SUBMIT);
+				DrawSplatter(splatter);
+				STAGE_END(STAGE_SUBMIT);
+				// Splat's unit of work is an accumulation
+				if (accumulated) {
+					observed_ns = SDL_GetTicksNS() - splat_start;
+				}
+			}
+			break;
+
+		case RENDER_INSTANCED:
+			if (block_renderer != NULL) {
+				STAGE_BEGIN(STAGE_GENERATE);
+				SetBlockRendererIFS(block_renderer, ifs_list[ifs_index]);
+				SetBlockRendererDepth(block_renderer, subdivide, block_depth);
+				STAGE_END(STAGE_GENERATE);
+				Uint64 submit_start = SDL_GetTicksNS();
+				STAGE_BEGIN(STAGE_SUBMIT);
+				DrawBlocks(block_renderer, view, perspective);
+				STAGE_END(STAGE_SUBMIT);
+				observed_ns = SDL_GetTicksNS() - submit_start;
+
+				// Report the submission in the title twice a second
+				if (!counting_overdraw &&
+				    block_renderer->instances != NULL &&
+				    SDL_GetTicks() - last_title_update > 500) {
+					RingBuffer *ring = block_renderer->indirect_ring;
+					char title[192];
+					snprintf(title, sizeof(title),
+					         "Sierpinski's Triangle - %u draw commands, "
+					         "%llu/%llu instances, %llu ring stalls (%.2f ms)",
+					         block_renderer->draw_commands,
+					         (unsigned long long)block_renderer->instances_drawn,
+					         (unsigned long long)
+					             block_renderer->instances->count,
+					         (unsigned long long)(ring ? ring->stalls : 0),
+					         ring ? (double)ring->stall_ns / 1e6 : 0.0);
+					SDL_SetWindowTitle(window, title);
+					last_title_update = SDL_GetTicks();
+				}
+			}
+			break;
+
+		default: {
+			Uint64 submit_start = SDL_GetTicksNS();
+			STAGE_BEGIN(STAGE_SUBMIT);
+			DrawRecursive(recursive, subdivide, view, perspective,
+			              front_to_back ? camera->pos : NULL);
+			STAGE_END(STAGE_SUBMIT);
+			observed_ns = SDL_GetTicksNS() - submit_start;
+			break;
+		}
+		}
+		if (counting_overdraw) {
+			EndOverdraw(overdraw);
+		}
+		EndPipelineStats(pipeline_stats);
+		EndGPUPass(gpu_timer, GPU_PASS_FRACTAL);
 
-		draw_serpinskis_triangle((vec3){0.0, 0.5, 0.0}, subdivide, 1.0,
-		                         model_uniform);
+		BeginGPUPass(gpu_timer, GPU_PASS_OVERLAY);
+		if (counting_overdraw) {
+			DrawOverdraw(overdraw);
+		}
+		if (show_hud && hud != NULL) {
+			HUDStats stats = {render_mode_names[render_mode], subdivide, 0, 0,
+			                  1};
+			if (render_mode == RENDER_INSTANCED) {
+				if (block_renderer != NULL &&
+				    block_renderer->instances != NULL) {
+					// Every instance is a block of leaves
+					Uint64 block_leaves = IFSLeafCount(
+					    block_renderer->ifs, block_renderer->block_depth);
+					stats.leaves_generated =
+					    block_renderer->instances->count * block_leaves;
+					stats.leaves_drawn =
+					    block_renderer->instances_drawn * block_leaves;
+					stats.draw_calls = block_renderer->draw_calls;
+				}
+			} else if (render_mode == RENDER_RECURSIVE) {
+				// Every pyramid is drawn on its own, none are culled
+				stats.leaves_generated = 1;
+				for (int i = 0; i < subdivide; i++) {
+					stats.leaves_generated *= 5;
+				}
+				stats.leaves_drawn = stats.leaves_generated;
+				stats.draw_calls = stats.leaves_generated;
+			}
+			UpdateHUD(hud, &stats);
+			DrawHUD(hud);
+		}
+		EndGPUPass(gpu_timer, GPU_PASS_OVERLAY);
+
+		// Report the fragments drawn in the title twice a second
+		if (counting_overdraw && SDL_GetTicks() - last_title_update > 500) {
+			char title[128];
+			snprintf(title, sizeof(title),
+			         "Sierpinski's Triangle - %llu fragments, %.2f per pixel",
+			         (unsigned long long)overdraw->samples->last,
+			         OverdrawPerPixel(overdraw));
+			SDL_SetWindowTitle(window, title);
+			last_title_update = SDL_GetTicks();
+		}
+
+		if (observed_ns > 0) {
+			ObserveFrame(governor, render_mode, subdivide, observed_ns);
+		}
+
+		TraceCounter("frame arena bytes", (double)frame_arena->used);
+		TraceCounter("depth", subdivide);
+		if (render_mode == RENDER_INSTANCED && block_renderer != NULL) {
+			TraceCounter("instances drawn",
+			             (double)block_renderer->instances_drawn);
+		}
 
+		STAGE_BEGIN(STAGE_SWAP);
 		SDL_GL_SwapWindow(window);
+		STAGE_END(STAGE_SWAP);
 
+		STAGE_BEGIN(STAGE_SLEEP);
 		TickClock(clock);
+		STAGE_END(STAGE_SLEEP);
+		EndGLStatsFrame();
+		TraceEnd("frame");
 	}
 
+	if (IsTracing() && WriteTrace(TRACE_FILE)) {
+		printf("Trace written to %s\n", TRACE_FILE);
+	}
+
+	PrintStageTimings();
+	WriteStageTimings(STAGE_TIMINGS_CSV);
+	PrintPipelineStats(pipeline_stats);
+	PrintMemoryStats();
+	if (GLStatsEnabled()) {
+		PrintGLStats();
+	}
+	if (gpu_timer->available) {
+		printf("GPU timer: %llu of %llu frames dropped\n",
+		       (unsigned long long)gpu_timer->dropped,
+		       (unsigned long long)gpu_timer->frames);
+	}
+
+	if (splatter != NULL) {
+		DestroySplatter(splatter);
+	}
+	DestroyTrace();
+	if (block_renderer != NULL) {
+		DestroyBlockRenderer(block_renderer);
+	}
+	if (overdraw != NULL) {
+		DestroyOverdraw(overdraw);
+	}
+	if (hud != NULL) {
+		DestroyHUD(hud);
+	}
+	DestroyPipelineStats(pipeline_stats);
+	DestroyGPUTimer(gpu_timer);
+	DestroyGovernor(governor);
+	PrintArenaStats(frame_arena);
+	DestroyArena(frame_arena);
 	SDL_CloseGamepad(gamepad);
 	DestroyClock(clock);
 	DestroyCamera(camera);
-	DeleteShaderProgram(program);
-	glDeleteVertexArrays(1, &vao);
-	glDeleteBuffers(1, &vbo);
+	DestroyRecursiveRenderer(recursive);
 	SDL_GL_DestroyContext(context);
 	SDL_DestroyWindow(window);
 	SDL_Quit();
@@ -304,67 +741,3 @@ void handle_mouse(void *user_data, Uint64 timestamp, SDL_Window *window,
 	float yaw = *x * camera_sensitivity;
 	RotateCamera(camera, -pitch, yaw);
 }
-
-void draw_triangle(vec3 top, float scale, unsigned int uniform_loc) {
-	vec3 center = {top[0], (top[1] - (0.5f * scale)), top[2]};
-
-	mat4 model = GLM_MAT4_IDENTITY_INIT;
-	glm_translate(model, center);
-	glm_scale(model, (vec3){scale, scale, scale});
-
-	glUniformMatrix4fv(uniform_loc, 1, GL_FALSE, (float *)model);
-	glDrawArrays(GL_TRIANGLES, 0, 18);
-}
-
-void draw_serpinskis_triangle(vec3 top, int subdivide, float scale,
-                              unsigned int uniform_loc) {
-	if (subdivide <= 0) { // Base case
-		draw_triangle(top, scale, uniform_loc);
-		return;
-	}
-
-	subdivide--;
-
-	/**
-	 *         top
-	 *          ^
-	 *         / \
-	 *        /   \
-	 * mid1  *     *  mid2
-	 *      /       \
-	 *     /         \
-	 * bl /_____*_____\  br
-	 *         mid3
-	 *
-	 */
-
-	vec3 mid_lf, mid_lb, mid_rf, mid_rb;
-	vec3 base_center;
-
-	float *corners[] = {mid_rf, mid_rb, mid_lb, mid_lf};
-
-	vec3 translations[] = {
-	    {0.5, -1.0, 0.5},
-	    {0.5, -1.0, -0.5},
-	    {-0.5, -1.0, -0.5},
-	    {-0.5, -1.0, 0.5},
-	};
-
-	// Rotates from right-front, right-back, left-back, and left-front.
-	scale *= 0.5f;
-	for (int i = 0; i < 4; i++) {
-		glm_vec3_scale(translations[i], scale, translations[i]);
-		glm_vec3_add(top, translations[i], corners[i]);
-	}
-
-	glm_vec3_add(mid_lf, mid_rb, base_center);
-	glm_vec3_divs(base_center, 2.0f, base_center);
-
-	draw_serpinskis_triangle(top, subdivide, scale, uniform_loc);
-	draw_serpinskis_triangle(mid_lf, subdivide, scale, uniform_loc);
-	draw_serpinskis_triangle(mid_lb, subdivide, scale, uniform_loc);
-	draw_serpinskis_triangle(mid_rf, subdivide, scale, uniform_loc);
-	draw_serpinskis_triangle(mid_rb, subdivide, scale, uniform_loc);
-
-	return;
-}
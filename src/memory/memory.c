@@ -0,0 +1,227 @@
+#include "memory/memory.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+#ifdef __APPLE__
+#include <mach/mach.h>
+#endif
+
+const char *memory_tag_names[MEMORY_TAG_COUNT] = {
+    "leaves", "meshes",    "culling", "splat",
+    "arenas", "shaders", "profiling", "app"};
+
+/**
+ * Put in front of every tagged block. The union keeps the block after it
+ * aligned for any type, like malloc's.
+ */
+typedef union BlockHeader {
+	struct {
+		size_t size;
+		MemoryTag tag;
+	} info;
+	max_align_t align;
+} BlockHeader;
+
+// A GL object counted by TrackGPUMemory
+typedef struct GPUObject {
+	GPUObjectKind kind;
+	unsigned int name;
+	MemoryTag tag;
+	Uint64 bytes;
+} GPUObject;
+
+static SDL_SpinLock lock;
+static MemoryUsage cpu[MEMORY_TAG_COUNT];
+static MemoryUsage cpu_total;
+static MemoryUsage gpu[MEMORY_TAG_COUNT];
+static MemoryUsage gpu_total;
+static GPUObject gpu_objects[MEMORY_MAX_GPU_OBJECTS];
+static int gpu_object_count = 0;
+
+// Count `bytes` more (or fewer) in `usage`, and `blocks` more blocks.
+static void count(MemoryUsage *usage, Sint64 bytes, Sint64 blocks) {
+	usage->live += (Uint64)bytes;
+	usage->blocks += (Uint64)blocks;
+	if (usage->live > usage->peak) {
+		usage->peak = usage->live;
+	}
+}
+
+// Count `block`'s bytes in or out of its tag.
+static void count_block(const BlockHeader *block, Sint64 sign) {
+	Sint64 bytes = sign * (Sint64)block->info.size;
+	SDL_LockSpinlock(&lock);
+	count(&cpu[block->info.tag], bytes, sign);
+	count(&cpu_total, bytes, sign);
+	SDL_UnlockSpinlock(&lock);
+}
+
+void *TaggedMalloc(MemoryTag tag, size_t size) {
+	BlockHeader *block = (BlockHeader *)malloc(sizeof(BlockHeader) + size);
+	if (block == NULL) {
+		return NULL;
+	}
+	block->info.size = size;
+	block->info.tag = tag;
+	count_block(block, 1);
+	return block + 1;
+}
+
+void *TaggedCalloc(MemoryTag tag, size_t count, size_t size) {
+	if (size != 0 && count > (SIZE_MAX - sizeof(BlockHeader)) / size) {
+		return NULL;
+	}
+	void *data = TaggedMalloc(tag, count * size);
+	if (data != NULL) {
+		memset(data, 0, count * size);
+	}
+	return data;
+}
+
+void *TaggedRealloc(MemoryTag tag, void *data, size_t size) {
+	if (data == NULL) {
+		return TaggedMalloc(tag, size);
+	}
+
+	BlockHeader *block = (BlockHeader *)data - 1;
+	size_t old_size = block->info.size;
+	BlockHeader *resized =
+	    (BlockHeader *)realloc(block, sizeof(BlockHeader) + size);
+	if (resized == NULL) {
+		return NULL;
+	}
+
+	SDL_LockSpinlock(&lock);
+	Sint64 change = (Sint64)size - (Sint64)old_size;
+	count(&cpu[resized->info.tag], change, 0);
+	count(&cpu_total, change, 0);
+	SDL_UnlockSpinlock(&lock);
+
+	resized->info.size = size;
+	return resized + 1;
+}
+
+void TaggedFree(void *data) {
+	if (data == NULL) {
+		return;
+	}
+	BlockHeader *block = (BlockHeader *)data - 1;
+	count_block(block, -1);
+	free(block);
+}
+
+// Index of the tracked object, or -1.
+static int find_gpu_object(GPUObjectKind kind, unsigned int name) {
+	for (int i = 0; i < gpu_object_count; i++) {
+		if (gpu_objects[i].kind == kind && gpu_objects[i].name == name) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+void TrackGPUMemory(MemoryTag tag, GPUObjectKind kind, unsigned int name,
+                    Uint64 bytes) {
+	ReleaseGPUMemory(kind, name);
+
+	SDL_LockSpinlock(&lock);
+	if (gpu_object_count < MEMORY_MAX_GPU_OBJECTS) {
+		gpu_objects[gpu_object_count++] = (GPUObject){kind, name, tag, bytes};
+		count(&gpu[tag], (Sint64)bytes, 1);
+		count(&gpu_total, (Sint64)bytes, 1);
+	}
+	SDL_UnlockSpinlock(&lock);
+}
+
+void ReleaseGPUMemory(GPUObjectKind kind, unsigned int name) {
+	SDL_LockSpinlock(&lock);
+	int i = find_gpu_object(kind, name);
+	if (i >= 0) {
+		GPUObject *object = &gpu_objects[i];
+		count(&gpu[object->tag], -(Sint64)object->bytes, -1);
+		count(&gpu_total, -(Sint64)object->bytes, -1);
+		*object = gpu_objects[--gpu_object_count];
+	}
+	SDL_UnlockSpinlock(&lock);
+}
+
+// Current and peak resident set size of the process, 0 where unknown.
+static void resident_size(Uint64 *rss, Uint64 *peak_rss) {
+	*rss = 0;
+	*peak_rss = 0;
+
+#if defined(__linux__)
+	FILE *file = fopen("/proc/self/statm", "r");
+	if (file != NULL) {
+		unsigned long size, resident;
+		if (fscanf(file, "%lu %lu", &size, &resident) == 2) {
+			*rss = (Uint64)resident * (Uint64)sysconf(_SC_PAGESIZE);
+		}
+		fclose(file);
+	}
+#elif defined(__APPLE__)
+	mach_task_basic_info_data_t info;
+	mach_msg_type_number_t info_count = MACH_TASK_BASIC_INFO_COUNT;
+	if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO,
+	              (task_info_t)&info, &info_count) == KERN_SUCCESS) {
+		*rss = (Uint64)info.resident_size;
+	}
+#endif
+
+#if defined(__linux__) || defined(__APPLE__)
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#ifdef __APPLE__
+		*peak_rss = (Uint64)usage.ru_maxrss; // Bytes
+#else
+		*peak_rss = (Uint64)usage.ru_maxrss * 1024; // Kilobytes
+#endif
+	}
+#endif
+}
+
+MemoryStats GetMemoryStats(void) {
+	MemoryStats stats;
+	SDL_LockSpinlock(&lock);
+	memcpy(stats.cpu, cpu, sizeof(cpu));
+	memcpy(stats.gpu, gpu, sizeof(gpu));
+	stats.cpu_total = cpu_total;
+	stats.gpu_total = gpu_total;
+	SDL_UnlockSpinlock(&lock);
+
+	resident_size(&stats.rss, &stats.peak_rss);
+	return stats;
+}
+
+void PrintMemoryStats(void) {
+	MemoryStats stats = GetMemoryStats();
+
+	printf("%10s %12s %12s %8s %12s %12s %8s\n", "memory", "cpu live",
+	       "cpu peak", "blocks", "gpu live", "gpu peak", "objects");
+	for (int t = 0; t < MEMORY_TAG_COUNT; t++) {
+		printf("%10s %12llu %12llu %8llu %12llu %12llu %8llu\n",
+		       memory_tag_names[t], (unsigned long long)stats.cpu[t].live,
+		       (unsigned long long)stats.cpu[t].peak,
+		       (unsigned long long)stats.cpu[t].blocks,
+		       (unsigned long long)stats.gpu[t].live,
+		       (unsigned long long)stats.gpu[t].peak,
+		       (unsigned long long)stats.gpu[t].blocks);
+	}
+	printf("%10s %12llu %12llu %8llu %12llu %12llu %8llu\n", "total",
+	       (unsigned long long)stats.cpu_total.live,
+	       (unsigned long long)stats.cpu_total.peak,
+	       (unsigned long long)stats.cpu_total.blocks,
+	       (unsigned long long)stats.gpu_total.live,
+	       (unsigned long long)stats.gpu_total.peak,
+	       (unsigned long long)stats.gpu_total.blocks);
+	printf("Resident: %.1f MiB, peak %.1f MiB\n",
+	       (double)stats.rss / (1024.0 * 1024.0),
+	       (double)stats.peak_rss / (1024.0 * 1024.0));
+}
@@ -0,0 +1,82 @@
+#ifndef MEMORY_H
+#define MEMORY_H
+
+#include <SDL3/SDL.h>
+#include <stddef.h>
+
+// GPU objects whose size can be tracked at once, later ones aren't counted
+#define MEMORY_MAX_GPU_OBJECTS 256
+
+// What memory is used for, every allocation is counted under one
+typedef enum MemoryTag {
+	MEMORY_LEAVES,    // Leaf buffers, their sort scratch and instance buffer
+	MEMORY_MESHES,    // Baked blocks and the scratch used to build them
+	MEMORY_CULLING,   // Visible ranges and indirect draw commands
+	MEMORY_SPLAT,     // Splatter histograms, image and texture
+	MEMORY_ARENAS,    // Arena blocks
+	MEMORY_SHADERS,   // Shader sources and objects
+	MEMORY_PROFILING, // Traces, queries, counters, the overdraw view and HUD
+	MEMORY_APP,       // Camera, clock, governor, renderers and the triangle
+	MEMORY_TAG_COUNT
+} MemoryTag;
+
+extern const char *memory_tag_names[MEMORY_TAG_COUNT];
+
+// Kinds of GL objects counted by TrackGPUMemory, their names can overlap
+typedef enum GPUObjectKind {
+	GPU_OBJECT_BUFFER,
+	GPU_OBJECT_TEXTURE,
+	GPU_OBJECT_RENDERBUFFER
+} GPUObjectKind;
+
+// Bytes held under one tag
+typedef struct MemoryUsage {
+	Uint64 live;
+	Uint64 peak;   // Most bytes live at once
+	Uint64 blocks; // Live allocations or GPU objects
+} MemoryUsage;
+
+// Snapshot of every tag, see GetMemoryStats
+typedef struct MemoryStats {
+	MemoryUsage cpu[MEMORY_TAG_COUNT];
+	MemoryUsage gpu[MEMORY_TAG_COUNT];
+	MemoryUsage cpu_total;
+	MemoryUsage gpu_total;
+	Uint64 rss;      // Resident set size of the process, 0 if unknown
+	Uint64 peak_rss; // Most resident at once, 0 if unknown
+} MemoryStats;
+
+/**
+ * malloc, calloc, realloc and free that count the bytes under `tag`.
+ *
+ * Every block starts with a header holding its size and tag, padded to the
+ * alignment of max_align_t (32 bytes on x86-64), so blocks must be freed
+ * with TaggedFree and never with free. Safe to call from any thread.
+ */
+void *TaggedMalloc(MemoryTag tag, size_t size);
+void *TaggedCalloc(MemoryTag tag, size_t count, size_t size);
+
+// Like realloc, `data` may be NULL. On failure `data` is left as it was.
+void *TaggedRealloc(MemoryTag tag, void *data, size_t size);
+
+// Free a block from TaggedMalloc, TaggedCalloc or TaggedRealloc, or NULL.
+void TaggedFree(void *data);
+
+/**
+ * Count `bytes` of GPU memory under `tag` for the GL object `name` of `kind`,
+ * replacing what it was counted with before, e.g. after every glBufferData.
+ * Drivers may use more for padding and mipmaps, this is what was asked for.
+ */
+void TrackGPUMemory(MemoryTag tag, GPUObjectKind kind, unsigned int name,
+                    Uint64 bytes);
+
+// Stop counting a GL object, when it is deleted.
+void ReleaseGPUMemory(GPUObjectKind kind, unsigned int name);
+
+// Live and peak bytes of every tag, and the process' resident size.
+MemoryStats GetMemoryStats(void);
+
+// Print live and peak CPU and GPU bytes per tag, and the resident size.
+void PrintMemoryStats(void);
+
+#endif // MEMORY_H
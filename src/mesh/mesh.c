@@ -0,0 +1,369 @@
+#include "mesh/mesh.h"
+
+#include <glad/glad.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "memory/memory.h"
+
+Uint16 FloatToHalf(float value) {
+	Uint32 bits;
+	memcpy(&bits, &value, sizeof(bits));
+
+	Uint32 sign = (bits >> 16) & 0x8000;
+	int exponent = (int)((bits >> 23) & 0xff) - 127 + 15;
+	Uint32 mantissa = bits & 0x7fffff;
+
+	if (exponent <= 0) {
+		return (Uint16)sign;
+	}
+	if (exponent >= 31) {
+		return (Uint16)(sign | 0x7c00);
+	}
+
+	// Round to nearest, ties to even. A carry out of the mantissa correctly
+	// bumps the exponent.
+	Uint32 half = sign | ((Uint32)exponent << 10) | (mantissa >> 13);
+	Uint32 rest = mantissa & 0x1fff;
+	if (rest > 0x1000 || (rest == 0x1000 && (half & 1))) {
+		half++;
+	}
+	return (Uint16)half;
+}
+
+void PackVertices(const float *vertices, Uint64 count, PackedVertex *out) {
+	for (Uint64 i = 0; i < count; i++) {
+		const float *in = &vertices[i * 6];
+		for (int c = 0; c < 3; c++) {
+			out[i].position[c] = FloatToHalf(in[c]);
+			out[i].color[c] = (Uint8)(in[3 + c] * 255.0f + 0.5f);
+		}
+		out[i].position[3] = FloatToHalf(1.0f);
+		out[i].color[3] = 255;
+	}
+}
+
+void SetupPackedVertexAttributes(void) {
+	glVertexAttribPointer(0, 3, GL_HALF_FLOAT, GL_FALSE, sizeof(PackedVertex),
+	                      (void *)offsetof(PackedVertex, position));
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(1, 3, GL_UNSIGNED_BYTE, GL_TRUE,
+	                      sizeof(PackedVertex),
+	                      (void *)offsetof(PackedVertex, color));
+	glEnableVertexAttribArray(1);
+}
+
+// An axis-aligned rectangle in the plane `position[axis] == plane`, spanning
+// [u0, u1] x [v0, v1] along the next two axes (axis + 1 and axis + 2).
+typedef struct Quad {
+	int axis;
+	float plane;
+	float u0, v0, u1, v1;
+	float color[3];
+	bool flip;   // Wound clockwise looking down the axis
+	int missing; // While pairing: the corner of the rectangle the triangle
+	             // doesn't touch, counter-clockwise from (u0, v0)
+	Uint64 triangle;
+} Quad;
+
+// Compare two arrays of floats lexicographically.
+static int compare_keys(const float *a, const float *b, int count) {
+	for (int i = 0; i < count; i++) {
+		if (a[i] != b[i]) {
+			return a[i] < b[i] ? -1 : 1;
+		}
+	}
+	return 0;
+}
+
+// Compare the rectangle and color of two quads, ignoring the winding.
+static int compare_rectangle_keys(const Quad *p, const Quad *q) {
+	float keys_p[] = {(float)p->axis, p->plane, p->u0, p->v0, p->u1,
+	                  p->v1, p->color[0], p->color[1], p->color[2]};
+	float keys_q[] = {(float)q->axis, q->plane, q->u0, q->v0, q->u1,
+	                  q->v1, q->color[0], q->color[1], q->color[2]};
+	return compare_keys(keys_p, keys_q, 9);
+}
+
+/**
+ * Group triangles covering the same rectangle in the same color, to pair
+ * them up, in mesh order within a group. Winding is left out: nothing culls
+ * back faces and the pyramid's base isn't wound consistently.
+ */
+static int compare_rectangles(const void *a, const void *b) {
+	const Quad *p = (const Quad *)a;
+	const Quad *q = (const Quad *)b;
+	int order = compare_rectangle_keys(p, q);
+	if (order != 0) {
+		return order;
+	}
+	return p->triangle < q->triangle ? -1 : p->triangle > q->triangle;
+}
+
+// Order quads into rows: same plane, color and `v` range, sorted along `u`.
+static int compare_rows(const void *a, const void *b) {
+	const Quad *p = (const Quad *)a;
+	const Quad *q = (const Quad *)b;
+	float keys_p[] = {(float)p->axis, p->plane, p->color[0], p->color[1],
+	                  p->color[2], (float)p->flip, p->v0, p->v1, p->u0};
+	float keys_q[] = {(float)q->axis, q->plane, q->color[0], q->color[1],
+	                  q->color[2], (float)q->flip, q->v0, q->v1, q->u0};
+	return compare_keys(keys_p, keys_q, 9);
+}
+
+// Order quads into columns: same plane, color and `u` range, sorted along
+// `v`.
+static int compare_columns(const void *a, const void *b) {
+	const Quad *p = (const Quad *)a;
+	const Quad *q = (const Quad *)b;
+	float keys_p[] = {(float)p->axis, p->plane, p->color[0], p->color[1],
+	                  p->color[2], (float)p->flip, p->u0, p->u1, p->v0};
+	float keys_q[] = {(float)q->axis, q->plane, q->color[0], q->color[1],
+	                  q->color[2], (float)q->flip, q->u0, q->u1, q->v0};
+	return compare_keys(keys_p, keys_q, 9);
+}
+
+/**
+ * If triangle `t` is a right triangle on three corners of an axis-aligned
+ * rectangle, in a single color, describe the rectangle in `quad`.
+ */
+static bool triangle_quad(const float *vertices, Uint64 t, Quad *quad) {
+	const float *p[3] = {&vertices[t * 18], &vertices[t * 18 + 6],
+	                     &vertices[t * 18 + 12]};
+
+	for (int i = 3; i < 6; i++) {
+		if (p[1][i] != p[0][i] || p[2][i] != p[0][i]) {
+			return false;
+		}
+	}
+
+	int axis = 0;
+	while (axis < 3 && (p[1][axis] != p[0][axis] || p[2][axis] != p[0][axis])) {
+		axis++;
+	}
+	if (axis == 3) {
+		return false;
+	}
+	int u = (axis + 1) % 3;
+	int v = (axis + 2) % 3;
+
+	quad->axis = axis;
+	quad->plane = p[0][axis];
+	quad->u0 = SDL_min(p[0][u], SDL_min(p[1][u], p[2][u]));
+	quad->u1 = SDL_max(p[0][u], SDL_max(p[1][u], p[2][u]));
+	quad->v0 = SDL_min(p[0][v], SDL_min(p[1][v], p[2][v]));
+	quad->v1 = SDL_max(p[0][v], SDL_max(p[1][v], p[2][v]));
+	if (quad->u0 == quad->u1 || quad->v0 == quad->v1) {
+		return false;
+	}
+
+	// Every vertex must be a distinct corner, which leaves one out
+	int corners = 0;
+	for (int i = 0; i < 3; i++) {
+		bool high_u = p[i][u] == quad->u1;
+		bool high_v = p[i][v] == quad->v1;
+		if ((!high_u && p[i][u] != quad->u0) ||
+		    (!high_v && p[i][v] != quad->v0)) {
+			return false;
+		}
+		// Counter-clockwise: (u0, v0), (u1, v0), (u1, v1), (u0, v1)
+		int corner = high_v ? (high_u ? 2 : 3) : (high_u ? 1 : 0);
+		if (corners & (1 << corner)) {
+			return false;
+		}
+		corners |= 1 << corner;
+	}
+	quad->missing = 0;
+	while (corners & (1 << quad->missing)) {
+		quad->missing++;
+	}
+
+	float cross = (p[1][u] - p[0][u]) * (p[2][v] - p[0][v]) -
+	              (p[1][v] - p[0][v]) * (p[2][u] - p[0][u]);
+	quad->flip = cross < 0.0f;
+	quad->color[0] = p[0][3];
+	quad->color[1] = p[0][4];
+	quad->color[2] = p[0][5];
+	quad->triangle = t;
+	return true;
+}
+
+/**
+ * Merge runs of quads that share an edge along `u` (rows) or `v` (columns)
+ * once they are sorted with the matching comparison. Returns the number of
+ * quads left, compacted to the front.
+ */
+static Uint64 merge_runs(Quad *quads, Uint64 count, bool rows) {
+	if (count == 0) {
+		return 0;
+	}
+
+	Uint64 kept = 0;
+	for (Uint64 i = 1; i < count; i++) {
+		Quad *last = &quads[kept];
+		const Quad *next = &quads[i];
+		bool same = last->axis == next->axis && last->plane == next->plane &&
+		            last->flip == next->flip &&
+		            last->color[0] == next->color[0] &&
+		            last->color[1] == next->color[1] &&
+		            last->color[2] == next->color[2];
+		if (same && rows && last->v0 == next->v0 && last->v1 == next->v1 &&
+		    last->u1 == next->u0) {
+			last->u1 = next->u1;
+		} else if (same && !rows && last->u0 == next->u0 &&
+		           last->u1 == next->u1 && last->v1 == next->v0) {
+			last->v1 = next->v1;
+		} else {
+			quads[++kept] = *next;
+		}
+	}
+	return kept + 1;
+}
+
+// Write a vertex of `quad` at (u, v) in the vertices.h layout.
+static void write_quad_vertex(const Quad *quad, float u, float v, float *out) {
+	out[quad->axis] = quad->plane;
+	out[(quad->axis + 1) % 3] = u;
+	out[(quad->axis + 2) % 3] = v;
+	out[3] = quad->color[0];
+	out[4] = quad->color[1];
+	out[5] = quad->color[2];
+}
+
+Uint64 MergeCoplanarFaces(float *vertices, Uint64 count) {
+	Uint64 triangles = count / 3;
+	Quad *candidates =
+	    (Quad *)TaggedMalloc(MEMORY_MESHES, sizeof(Quad) * (triangles + 1));
+	bool *merged =
+	    (bool *)TaggedCalloc(MEMORY_MESHES, triangles + 1, sizeof(bool));
+	if (candidates == NULL || merged == NULL) {
+		perror("Could not allocate memory to merge faces");
+		TaggedFree(candidates);
+		TaggedFree(merged);
+		return count;
+	}
+
+	Uint64 candidate_count = 0;
+	for (Uint64 t = 0; t < triangles; t++) {
+		if (triangle_quad(vertices, t, &candidates[candidate_count])) {
+			candidate_count++;
+		}
+	}
+
+	// Pair up the two halves of every rectangle, which sort next to each
+	// other. A pair is wound like its first triangle.
+	qsort(candidates, candidate_count, sizeof(Quad), compare_rectangles);
+	Uint64 quad_count = 0;
+	Uint64 group_end;
+	for (Uint64 group = 0; group < candidate_count; group = group_end) {
+		group_end = group + 1;
+		while (group_end < candidate_count &&
+		       compare_rectangle_keys(&candidates[group],
+		                              &candidates[group_end]) == 0) {
+			group_end++;
+		}
+
+		// Usually two triangles, more where primitives overlap
+		for (Uint64 i = group; i < group_end; i++) {
+			const Quad *a = &candidates[i];
+			if (merged[a->triangle]) {
+				continue;
+			}
+			for (Uint64 j = i + 1; j < group_end; j++) {
+				const Quad *b = &candidates[j];
+				if (!merged[b->triangle] &&
+				    (a->missing + 2) % 4 == b->missing) {
+					merged[a->triangle] = true;
+					merged[b->triangle] = true;
+					candidates[quad_count++] = *a;
+					break;
+				}
+			}
+		}
+	}
+
+	// Alternate merging rows and columns until nothing changes
+	for (;;) {
+		Uint64 before = quad_count;
+		qsort(candidates, quad_count, sizeof(Quad), compare_rows);
+		quad_count = merge_runs(candidates, quad_count, true);
+		qsort(candidates, quad_count, sizeof(Quad), compare_columns);
+		quad_count = merge_runs(candidates, quad_count, false);
+		if (quad_count == before) {
+			break;
+		}
+	}
+
+	// Keep the triangles that weren't paired, then add two per quad
+	Uint64 out = 0;
+	for (Uint64 t = 0; t < triangles; t++) {
+		if (!merged[t]) {
+			memmove(&vertices[out * 6], &vertices[t * 18],
+			        sizeof(float) * 18);
+			out += 3;
+		}
+	}
+	for (Uint64 i = 0; i < quad_count; i++) {
+		const Quad *quad = &candidates[i];
+		float corners[4][2] = {{quad->u0, quad->v0},
+		                       {quad->u1, quad->v0},
+		                       {quad->u1, quad->v1},
+		                       {quad->u0, quad->v1}};
+		static const int ccw[6] = {0, 1, 2, 0, 2, 3};
+		static const int cw[6] = {0, 2, 1, 0, 3, 2};
+		const int *order = quad->flip ? cw : ccw;
+		for (int v = 0; v < 6; v++) {
+			write_quad_vertex(quad, corners[order[v]][0],
+			                  corners[order[v]][1], &vertices[out * 6]);
+			out++;
+		}
+	}
+
+	TaggedFree(candidates);
+	TaggedFree(merged);
+	return out;
+}
+
+// FNV-1a over the bytes of a packed vertex.
+static Uint32 hash_vertex(const PackedVertex *vertex) {
+	const Uint8 *bytes = (const Uint8 *)vertex;
+	Uint32 hash = 2166136261u;
+	for (size_t i = 0; i < sizeof(PackedVertex); i++) {
+		hash = (hash ^ bytes[i]) * 16777619u;
+	}
+	return hash;
+}
+
+Uint32 WeldVertices(const PackedVertex *vertices, Uint64 count,
+                    PackedVertex *unique, Uint32 *indices) {
+	// Open addressing, at most half full. Slots hold an index + 1.
+	Uint64 size = 1;
+	while (size < count * 2) {
+		size <<= 1;
+	}
+	Uint32 *slots = (Uint32 *)TaggedCalloc(MEMORY_MESHES, size, sizeof(Uint32));
+	if (slots == NULL) {
+		perror("Could not allocate memory to weld vertices");
+		return 0;
+	}
+
+	Uint32 unique_count = 0;
+	for (Uint64 i = 0; i < count; i++) {
+		Uint64 slot = hash_vertex(&vertices[i]) & (size - 1);
+		while (slots[slot] != 0 &&
+		       memcmp(&unique[slots[slot] - 1], &vertices[i],
+		              sizeof(PackedVertex)) != 0) {
+			slot = (slot + 1) & (size - 1);
+		}
+		if (slots[slot] == 0) {
+			unique[unique_count++] = vertices[i];
+			slots[slot] = unique_count;
+		}
+		indices[i] = slots[slot] - 1;
+	}
+
+	TaggedFree(slots);
+	return unique_count;
+}
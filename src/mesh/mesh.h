@@ -0,0 +1,61 @@
+#ifndef MESH_H
+#define MESH_H
+
+#include <SDL3/SDL.h>
+
+/**
+ * Compact vertex layout for the pyramid meshes, 12 bytes instead of the 24 of
+ * the interleaved floats in `vertices.h`.
+ *
+ * Positions are half floats, rounded to nearest. Coordinates of the pyramid
+ * and tetrahedron meshes are multiples of 2^-(k+1) in [-0.5, 0.5], which
+ * half floats represent exactly. Those of the IFSs with a ratio of 1/3
+ * (Menger, Vicsek, Cantor) aren't, and move by at most 2^-13 (half an ulp
+ * below 0.5, flushed subnormals are smaller still) of the block's size.
+ * The fourth half is padding set to 1.0 to keep the color 4-byte aligned.
+ * Colors are RGBA8, read back as normalized floats.
+ */
+typedef struct PackedVertex {
+	Uint16 position[4];
+	Uint8 color[4];
+} PackedVertex;
+
+// Convert a float to the nearest half float (subnormals flush to zero).
+Uint16 FloatToHalf(float value);
+
+/**
+ * Pack `count` vertices in the `vertices.h` layout (3 position and 3 color
+ * floats each) into `out`.
+ */
+void PackVertices(const float *vertices, Uint64 count, PackedVertex *out);
+
+/**
+ * Point attributes 0 (position) and 1 (color) of the bound VAO at the
+ * packed vertices in the buffer bound to GL_ARRAY_BUFFER.
+ */
+void SetupPackedVertexAttributes(void);
+
+/**
+ * Merge coplanar faces of the same color in `count` vertices in the
+ * `vertices.h` layout, in place, and return the new vertex count.
+ *
+ * Pairs of triangles covering an axis-aligned rectangle are turned into
+ * quads, which are grown greedily along rows and columns of the same plane,
+ * color and winding, then written back as two triangles each. Other
+ * triangles are kept as they are. Merging can leave T-junctions where the
+ * merged faces meet the kept ones.
+ */
+Uint64 MergeCoplanarFaces(float *vertices, Uint64 count);
+
+/**
+ * Weld bit-identical vertices for indexed drawing. The distinct ones of the
+ * `count` `vertices` are written to `unique` (room for `count`) in order of
+ * first use, and one index into them per input vertex to `indices`, so the
+ * result only depends on the input.
+ *
+ * Returns the number of distinct vertices, or 0 if out of memory.
+ */
+Uint32 WeldVertices(const PackedVertex *vertices, Uint64 count,
+                    PackedVertex *unique, Uint32 *indices);
+
+#endif // MESH_H
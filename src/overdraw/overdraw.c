@@ -0,0 +1,130 @@
+#include "overdraw/overdraw.h"
+
+#include <glad/glad.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "memory/memory.h"
+
+Overdraw *CreateOverdraw(int width, int height) {
+	Overdraw *overdraw =
+	    (Overdraw *)TaggedCalloc(MEMORY_PROFILING, 1, sizeof(Overdraw));
+	if (overdraw == NULL) {
+		perror("Could not allocate memory for overdraw view");
+		return NULL;
+	}
+	overdraw->width = width;
+	overdraw->height = height;
+
+	overdraw->samples = CreateSampleCounter();
+	if (overdraw->samples == NULL) {
+		TaggedFree(overdraw);
+		return NULL;
+	}
+
+	// Half floats count exactly up to 2048 layers and can be blended
+	glGenTextures(1, &overdraw->counts);
+	glBindTexture(GL_TEXTURE_2D, overdraw->counts);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, width, height, 0, GL_RGBA,
+	             GL_FLOAT, NULL);
+	TrackGPUMemory(MEMORY_PROFILING, GPU_OBJECT_TEXTURE, overdraw->counts,
+	               (Uint64)width * height * 8);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+	glGenRenderbuffers(1, &overdraw->depth);
+	glBindRenderbuffer(GL_RENDERBUFFER, overdraw->depth);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width,
+	                      height);
+	TrackGPUMemory(MEMORY_PROFILING, GPU_OBJECT_RENDERBUFFER, overdraw->depth,
+	               (Uint64)width * height * 4);
+
+	glGenFramebuffers(1, &overdraw->framebuffer);
+	glBindFramebuffer(GL_FRAMEBUFFER, overdraw->framebuffer);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+	                       GL_TEXTURE_2D, overdraw->counts, 0);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT,
+	                          GL_RENDERBUFFER, overdraw->depth);
+	GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	if (status != GL_FRAMEBUFFER_COMPLETE) {
+		printf("Could not create the overdraw framebuffer (0x%x)\n", status);
+		DestroyOverdraw(overdraw);
+		return NULL;
+	}
+
+	glGenVertexArrays(1, &overdraw->vao);
+
+	// splat.vert is the same full-screen triangle
+	overdraw->program = LoadShaderProgram("splat.vert", "overdraw.frag");
+	if (overdraw->program != NULL) {
+		overdraw->max_layers_uniform =
+		    glGetUniformLocation(*overdraw->program, "max_layers");
+	}
+
+	return overdraw;
+}
+
+void DestroyOverdraw(Overdraw *overdraw) {
+	if (overdraw->program != NULL) {
+		DeleteShaderProgram(overdraw->program);
+	}
+	glDeleteVertexArrays(1, &overdraw->vao);
+	glDeleteFramebuffers(1, &overdraw->framebuffer);
+	ReleaseGPUMemory(GPU_OBJECT_RENDERBUFFER, overdraw->depth);
+	ReleaseGPUMemory(GPU_OBJECT_TEXTURE, overdraw->counts);
+	glDeleteRenderbuffers(1, &overdraw->depth);
+	glDeleteTextures(1, &overdraw->counts);
+	DestroySampleCounter(overdraw->samples);
+	TaggedFree(overdraw);
+}
+
+void BeginOverdraw(Overdraw *overdraw) {
+	glBindFramebuffer(GL_FRAMEBUFFER, overdraw->framebuffer);
+	glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_ONE, GL_ONE);
+	glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_TRUE);
+
+	BeginSampleCount(overdraw->samples);
+}
+
+void EndOverdraw(Overdraw *overdraw) {
+	EndSampleCount(overdraw->samples);
+
+	glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+	glDisable(GL_BLEND);
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void DrawOverdraw(Overdraw *overdraw) {
+	if (overdraw->program == NULL) {
+		return;
+	}
+
+	GLint previous_program, previous_vao;
+	glGetIntegerv(GL_CURRENT_PROGRAM, &previous_program);
+	glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &previous_vao);
+
+	UseShaderProgram(overdraw->program);
+	glUniform1f(overdraw->max_layers_uniform, OVERDRAW_MAX_LAYERS);
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, overdraw->counts);
+
+	glDisable(GL_DEPTH_TEST);
+	glBindVertexArray(overdraw->vao);
+	glDrawArrays(GL_TRIANGLES, 0, 3);
+	glEnable(GL_DEPTH_TEST);
+
+	glBindVertexArray(previous_vao);
+	glUseProgram(previous_program);
+}
+
+double OverdrawPerPixel(const Overdraw *overdraw) {
+	return (double)overdraw->samples->last /
+	       ((double)overdraw->width * (double)overdraw->height);
+}
@@ -0,0 +1,57 @@
+#ifndef OVERDRAW_H
+#define OVERDRAW_H
+
+#include <SDL3/SDL.h>
+
+#include "query/query.h"
+#include "shaders/shader.h"
+
+// Fragments per pixel shown as white in the heatmap
+#define OVERDRAW_MAX_LAYERS 8.0f
+
+/**
+ * Overdraw view: the fractal is drawn into an offscreen target that counts
+ * the fragments written to each pixel, which is then shown as a heatmap
+ * (blue for one, through green, yellow and red, to white at
+ * OVERDRAW_MAX_LAYERS or more).
+ *
+ * shader.frag always writes an alpha of 1, so with additive blending and
+ * only alpha writes enabled, the target's alpha becomes the count without a
+ * separate shader for every program that draws the fractal. The depth test
+ * stays on, so what is counted is what gets shaded after early-Z, and
+ * front-to-back order shows up.
+ *
+ * The samples passed while drawing are counted too, for the exact total.
+ */
+typedef struct Overdraw {
+	int width;
+	int height;
+	unsigned int framebuffer;
+	unsigned int counts; // RGBA16F, the count is in alpha
+	unsigned int depth;  // Renderbuffer
+	unsigned int vao;    // Empty, for the full-screen triangle
+	ShaderProgram *program;
+	int max_layers_uniform;
+	SampleCounter *samples;
+} Overdraw;
+
+// Create the counting target and heatmap shader for a `width` by `height`
+// window.
+Overdraw *CreateOverdraw(int width, int height);
+
+// Delete an overdraw view and its GL objects.
+void DestroyOverdraw(Overdraw *overdraw);
+
+// Clear the counts and redirect drawing into them.
+void BeginOverdraw(Overdraw *overdraw);
+
+// Go back to drawing to the window, with blending and writes as before.
+void EndOverdraw(Overdraw *overdraw);
+
+// Draw the counts as a heatmap over the whole window.
+void DrawOverdraw(Overdraw *overdraw);
+
+// Fragments drawn per pixel in the latest frame counted.
+double OverdrawPerPixel(const Overdraw *overdraw);
+
+#endif // OVERDRAW_H
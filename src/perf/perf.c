@@ -0,0 +1,97 @@
+#include "perf/perf.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "memory/memory.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+static int open_counter(Uint64 config, int group_fd) {
+	struct perf_event_attr attr;
+	memset(&attr, 0, sizeof(attr));
+	attr.size = sizeof(attr);
+	attr.type = PERF_TYPE_HARDWARE;
+	attr.config = config;
+	attr.disabled = group_fd == -1;
+	attr.exclude_kernel = 1;
+	attr.exclude_hv = 1;
+
+	return (int)syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0);
+}
+#endif
+
+PerfCounters *CreatePerfCounters(void) {
+	PerfCounters *counters =
+	    (PerfCounters *)TaggedCalloc(MEMORY_PROFILING, 1, sizeof(PerfCounters));
+	if (counters == NULL) {
+		perror("Could not allocate memory for perf counters");
+		return NULL;
+	}
+
+	counters->references_fd = -1;
+	counters->misses_fd = -1;
+
+#ifdef __linux__
+	// Misses are grouped with references so both cover the same interval
+	counters->references_fd =
+	    open_counter(PERF_COUNT_HW_CACHE_REFERENCES, -1);
+	if (counters->references_fd != -1) {
+		counters->misses_fd = open_counter(PERF_COUNT_HW_CACHE_MISSES,
+		                                   counters->references_fd);
+	}
+	counters->available =
+	    counters->references_fd != -1 && counters->misses_fd != -1;
+#endif
+
+	return counters;
+}
+
+void DestroyPerfCounters(PerfCounters *counters) {
+#ifdef __linux__
+	if (counters->misses_fd != -1) {
+		close(counters->misses_fd);
+	}
+	if (counters->references_fd != -1) {
+		close(counters->references_fd);
+	}
+#endif
+	TaggedFree(counters);
+}
+
+void StartPerfCounters(PerfCounters *counters) {
+#ifdef __linux__
+	if (counters->available) {
+		ioctl(counters->references_fd, PERF_EVENT_IOC_RESET,
+		      PERF_IOC_FLAG_GROUP);
+		ioctl(counters->references_fd, PERF_EVENT_IOC_ENABLE,
+		      PERF_IOC_FLAG_GROUP);
+	}
+#else
+	(void)counters;
+#endif
+}
+
+void StopPerfCounters(PerfCounters *counters) {
+	counters->references = 0;
+	counters->misses = 0;
+
+#ifdef __linux__
+	if (counters->available) {
+		ioctl(counters->references_fd, PERF_EVENT_IOC_DISABLE,
+		      PERF_IOC_FLAG_GROUP);
+		if (read(counters->references_fd, &counters->references,
+		         sizeof(Uint64)) != sizeof(Uint64) ||
+		    read(counters->misses_fd, &counters->misses, sizeof(Uint64)) !=
+		        sizeof(Uint64)) {
+			counters->references = 0;
+			counters->misses = 0;
+		}
+	}
+#endif
+}
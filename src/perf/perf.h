@@ -0,0 +1,33 @@
+#ifndef PERF_H
+#define PERF_H
+
+#include <SDL3/SDL.h>
+
+/**
+ * Hardware cache counters for the calling thread, read through Linux perf
+ * events. `available` is false on other platforms, or when the kernel
+ * doesn't allow it (see /proc/sys/kernel/perf_event_paranoid).
+ */
+typedef struct PerfCounters {
+	bool available;
+	int references_fd;
+	int misses_fd;
+
+	// Results of the last StopPerfCounters
+	Uint64 references;
+	Uint64 misses;
+} PerfCounters;
+
+// Open the cache reference and cache miss counters.
+PerfCounters *CreatePerfCounters(void);
+
+// Close the counters.
+void DestroyPerfCounters(PerfCounters *counters);
+
+// Reset and start counting.
+void StartPerfCounters(PerfCounters *counters);
+
+// Stop counting and store the counts in `references` and `misses`.
+void StopPerfCounters(PerfCounters *counters);
+
+#endif // PERF_H
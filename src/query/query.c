@@ -0,0 +1,295 @@
+#include "query/query.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "glext/glext.h"
+#include "memory/memory.h"
+#include "timing/timing.h"
+
+FragmentCounter *CreateFragmentCounter(void) {
+	FragmentCounter *counter = (FragmentCounter *)TaggedMalloc(
+	    MEMORY_PROFILING, sizeof(FragmentCounter));
+	if (counter == NULL) {
+		perror("Could not allocate memory for fragment counter");
+		return NULL;
+	}
+
+	if (gl_extensions.pipeline_statistics) {
+		counter->target = GL_FRAGMENT_SHADER_INVOCATIONS_ARB;
+		counter->name = "fragment shader invocations";
+	} else {
+		counter->target = GL_SAMPLES_PASSED;
+		counter->name = "samples passed";
+	}
+	glGenQueries(1, &counter->query);
+
+	return counter;
+}
+
+void DestroyFragmentCounter(FragmentCounter *counter) {
+	glDeleteQueries(1, &counter->query);
+	TaggedFree(counter);
+}
+
+void BeginFragmentCount(FragmentCounter *counter) {
+	glBeginQuery(counter->target, counter->query);
+}
+
+Uint64 EndFragmentCount(FragmentCounter *counter) {
+	glEndQuery(counter->target);
+
+	GLuint64 count = 0;
+	glGetQueryObjectui64v(counter->query, GL_QUERY_RESULT, &count);
+	return count;
+}
+
+const char *pipeline_stat_names[PIPELINE_STAT_COUNT] = {
+    "vertices submitted",         "primitives submitted",
+    "vertex shader invocations",  "clipping input primitives",
+    "clipping output primitives", "fragment shader invocations"};
+
+static const GLenum pipeline_stat_targets[PIPELINE_STAT_COUNT] = {
+    GL_VERTICES_SUBMITTED_ARB,         GL_PRIMITIVES_SUBMITTED_ARB,
+    GL_VERTEX_SHADER_INVOCATIONS_ARB,  GL_CLIPPING_INPUT_PRIMITIVES_ARB,
+    GL_CLIPPING_OUTPUT_PRIMITIVES_ARB, GL_FRAGMENT_SHADER_INVOCATIONS_ARB};
+
+PipelineStats *CreatePipelineStats(void) {
+	PipelineStats *stats = (PipelineStats *)TaggedCalloc(
+	    MEMORY_PROFILING, 1, sizeof(PipelineStats));
+	if (stats == NULL) {
+		perror("Could not allocate memory for pipeline statistics");
+		return NULL;
+	}
+
+	stats->available = gl_extensions.pipeline_statistics;
+	if (stats->available) {
+		glGenQueries(GPU_TIMER_FRAMES * PIPELINE_STAT_COUNT,
+		             &stats->queries[0][0]);
+	}
+	return stats;
+}
+
+void DestroyPipelineStats(PipelineStats *stats) {
+	if (stats->available) {
+		glDeleteQueries(GPU_TIMER_FRAMES * PIPELINE_STAT_COUNT,
+		                &stats->queries[0][0]);
+	}
+	TaggedFree(stats);
+}
+
+// Add the counts of query set `frame` if they are all done.
+static void read_pipeline_stats(PipelineStats *stats, int frame) {
+	for (int s = 0; s < PIPELINE_STAT_COUNT; s++) {
+		GLint available = 0;
+		glGetQueryObjectiv(stats->queries[frame][s], GL_QUERY_RESULT_AVAILABLE,
+		                   &available);
+		if (!available) {
+			stats->dropped++;
+			return;
+		}
+	}
+
+	for (int s = 0; s < PIPELINE_STAT_COUNT; s++) {
+		GLuint64 count = 0;
+		glGetQueryObjectui64v(stats->queries[frame][s], GL_QUERY_RESULT,
+		                      &count);
+		stats->last[s] = count;
+		stats->total[s] += count;
+		TraceCounter(pipeline_stat_names[s], (double)count);
+	}
+	stats->counted++;
+}
+
+void BeginPipelineStats(PipelineStats *stats) {
+	if (!stats->available) {
+		return;
+	}
+
+	stats->frame = (int)(stats->frames % GPU_TIMER_FRAMES);
+	if (stats->issued[stats->frame]) {
+		read_pipeline_stats(stats, stats->frame);
+	}
+	for (int s = 0; s < PIPELINE_STAT_COUNT; s++) {
+		glBeginQuery(pipeline_stat_targets[s], stats->queries[stats->frame][s]);
+	}
+	stats->frames++;
+}
+
+void EndPipelineStats(PipelineStats *stats) {
+	if (!stats->available) {
+		return;
+	}
+
+	for (int s = 0; s < PIPELINE_STAT_COUNT; s++) {
+		glEndQuery(pipeline_stat_targets[s]);
+	}
+	stats->issued[stats->frame] = true;
+}
+
+// `a` / `b`, or 0 when nothing was counted.
+static double ratio(Uint64 a, Uint64 b) {
+	return b > 0 ? (double)a / (double)b : 0.0;
+}
+
+void PrintPipelineStats(const PipelineStats *stats) {
+	if (!stats->available) {
+		printf("Pipeline statistics need GL 4.6 or "
+		       "ARB_pipeline_statistics_query\n");
+		return;
+	}
+	if (stats->counted == 0) {
+		printf("No pipeline statistics read back yet\n");
+		return;
+	}
+
+	printf("Fractal pass pipeline statistics over %llu frames (%llu "
+	       "dropped):\n",
+	       (unsigned long long)stats->counted,
+	       (unsigned long long)stats->dropped);
+	printf("%28s %14s %14s\n", "statistic", "last frame", "average");
+	for (int s = 0; s < PIPELINE_STAT_COUNT; s++) {
+		printf("%28s %14llu %14.0f\n", pipeline_stat_names[s],
+		       (unsigned long long)stats->last[s],
+		       (double)stats->total[s] / (double)stats->counted);
+	}
+
+	const Uint64 *last = stats->last;
+	printf("Vertex shader invocations per vertex submitted: %.3f\n",
+	       ratio(last[PIPELINE_VERTEX_SHADER_INVOCATIONS],
+	             last[PIPELINE_VERTICES_SUBMITTED]));
+	printf("Primitives kept by clipping: %.1f%%\n",
+	       100.0 * ratio(last[PIPELINE_CLIPPING_OUTPUT_PRIMITIVES],
+	                     last[PIPELINE_CLIPPING_INPUT_PRIMITIVES]));
+	printf("Fragment shader invocations per vertex shader invocation: %.3f\n",
+	       ratio(last[PIPELINE_FRAGMENT_SHADER_INVOCATIONS],
+	             last[PIPELINE_VERTEX_SHADER_INVOCATIONS]));
+}
+
+SampleCounter *CreateSampleCounter(void) {
+	SampleCounter *counter = (SampleCounter *)TaggedCalloc(
+	    MEMORY_PROFILING, 1, sizeof(SampleCounter));
+	if (counter == NULL) {
+		perror("Could not allocate memory for sample counter");
+		return NULL;
+	}
+
+	glGenQueries(GPU_TIMER_FRAMES, counter->queries);
+	return counter;
+}
+
+void DestroySampleCounter(SampleCounter *counter) {
+	glDeleteQueries(GPU_TIMER_FRAMES, counter->queries);
+	TaggedFree(counter);
+}
+
+void BeginSampleCount(SampleCounter *counter) {
+	counter->frame = (int)(counter->frames % GPU_TIMER_FRAMES);
+	unsigned int query = counter->queries[counter->frame];
+
+	if (counter->issued[counter->frame]) {
+		GLint available = 0;
+		glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+		if (available) {
+			GLuint64 samples = 0;
+			glGetQueryObjectui64v(query, GL_QUERY_RESULT, &samples);
+			counter->last = samples;
+			TraceCounter("samples passed", (double)samples);
+		} else {
+			counter->dropped++;
+		}
+	}
+
+	glBeginQuery(GL_SAMPLES_PASSED, query);
+	counter->frames++;
+}
+
+void EndSampleCount(SampleCounter *counter) {
+	glEndQuery(GL_SAMPLES_PASSED);
+	counter->issued[counter->frame] = true;
+}
+
+GPUTimer *CreateGPUTimer(void) {
+	GPUTimer *timer =
+	    (GPUTimer *)TaggedCalloc(MEMORY_PROFILING, 1, sizeof(GPUTimer));
+	if (timer == NULL) {
+		perror("Could not allocate memory for GPU timer");
+		return NULL;
+	}
+
+	timer->available = gl_extensions.timer_query;
+	if (timer->available) {
+		glGenQueries(GPU_TIMER_FRAMES * GPU_PASS_COUNT * 2,
+		             &timer->queries[0][0][0]);
+	}
+	return timer;
+}
+
+void DestroyGPUTimer(GPUTimer *timer) {
+	if (timer->available) {
+		glDeleteQueries(GPU_TIMER_FRAMES * GPU_PASS_COUNT * 2,
+		                &timer->queries[0][0][0]);
+	}
+	TaggedFree(timer);
+}
+
+// Record the passes of query set `frame` if they are all done.
+static void read_frame(GPUTimer *timer, int frame) {
+	for (int p = 0; p < GPU_PASS_COUNT; p++) {
+		if (!timer->issued[frame][p]) {
+			continue;
+		}
+		// The end is issued last, so the begin is done once it is
+		GLint available = 0;
+		glGetQueryObjectiv(timer->queries[frame][p][1],
+		                   GL_QUERY_RESULT_AVAILABLE, &available);
+		if (!available) {
+			timer->dropped++;
+			return;
+		}
+	}
+
+	for (int p = 0; p < GPU_PASS_COUNT; p++) {
+		if (!timer->issued[frame][p]) {
+			continue;
+		}
+		GLuint64 begin = 0, end = 0;
+		glGetQueryObjectui64v(timer->queries[frame][p][0], GL_QUERY_RESULT,
+		                      &begin);
+		glGetQueryObjectui64v(timer->queries[frame][p][1], GL_QUERY_RESULT,
+		                      &end);
+
+		Stage stage = (Stage)(STAGE_GPU_CLEAR + p);
+		Uint64 ns = end > begin ? end - begin : 0;
+		RecordStage(stage, ns);
+		TraceCounter(stage_names[stage], (double)ns / 1e6);
+	}
+}
+
+void BeginGPUFrame(GPUTimer *timer) {
+	if (!timer->available) {
+		return;
+	}
+
+	timer->frame = (int)(timer->frames % GPU_TIMER_FRAMES);
+	if (timer->frames >= GPU_TIMER_FRAMES) {
+		read_frame(timer, timer->frame);
+	}
+	for (int p = 0; p < GPU_PASS_COUNT; p++) {
+		timer->issued[timer->frame][p] = false;
+	}
+	timer->frames++;
+}
+
+void BeginGPUPass(GPUTimer *timer, GPUPass pass) {
+	if (timer->available) {
+		glQueryCounter(timer->queries[timer->frame][pass][0], GL_TIMESTAMP);
+	}
+}
+
+void EndGPUPass(GPUTimer *timer, GPUPass pass) {
+	if (timer->available) {
+		glQueryCounter(timer->queries[timer->frame][pass][1], GL_TIMESTAMP);
+		timer->issued[timer->frame][pass] = true;
+	}
+}
@@ -0,0 +1,174 @@
+#ifndef QUERY_H
+#define QUERY_H
+
+#include <SDL3/SDL.h>
+
+/**
+ * Counts the fragments produced by the draws between BeginFragmentCount and
+ * EndFragmentCount.
+ *
+ * Uses fragment shader invocations from pipeline statistics when available.
+ * Otherwise it falls back to samples passed, which counts fragments that
+ * survive the depth test. With early-Z those are the ones that get shaded.
+ */
+typedef struct FragmentCounter {
+	unsigned int query;
+	unsigned int target;
+	const char *name; // What is being counted, for printing
+} FragmentCounter;
+
+// Create a fragment counter.
+FragmentCounter *CreateFragmentCounter(void);
+
+// Delete the counter's query object.
+void DestroyFragmentCounter(FragmentCounter *counter);
+
+// Start counting fragments.
+void BeginFragmentCount(FragmentCounter *counter);
+
+// Stop counting and wait for the result. Stalls, so only for benchmarks.
+Uint64 EndFragmentCount(FragmentCounter *counter);
+
+// Frames a GPU timer's queries get before they are read back
+#define GPU_TIMER_FRAMES 4
+
+// Pipeline statistics counted per frame, in pipeline order
+typedef enum PipelineStat {
+	PIPELINE_VERTICES_SUBMITTED,
+	PIPELINE_PRIMITIVES_SUBMITTED,
+	PIPELINE_VERTEX_SHADER_INVOCATIONS,
+	PIPELINE_CLIPPING_INPUT_PRIMITIVES,
+	PIPELINE_CLIPPING_OUTPUT_PRIMITIVES,
+	PIPELINE_FRAGMENT_SHADER_INVOCATIONS,
+	PIPELINE_STAT_COUNT
+} PipelineStat;
+
+extern const char *pipeline_stat_names[PIPELINE_STAT_COUNT];
+
+/**
+ * What every stage of the pipeline did in one part of each frame, from
+ * ARB_pipeline_statistics_query. All the queries are active at once and are
+ * read back GPU_TIMER_FRAMES frames later like GPUTimer's, dropping a frame
+ * rather than waiting for it.
+ *
+ * Vertex shader invocations against vertices submitted shows how much the
+ * post-transform cache and instancing save, clipping output against input
+ * how many primitives are outside the view, and fragment shader invocations
+ * against vertex shader invocations whether the pass leans on the vertex or
+ * the fragment side.
+ *
+ * Without the extension (GL 4.6 core) `available` is false and nothing is
+ * counted.
+ */
+typedef struct PipelineStats {
+	bool available;
+	unsigned int queries[GPU_TIMER_FRAMES][PIPELINE_STAT_COUNT];
+	bool issued[GPU_TIMER_FRAMES];
+	int frame; // Set of queries used this frame
+	Uint64 frames;
+	Uint64 dropped; // Frames whose results weren't ready in time
+
+	Uint64 last[PIPELINE_STAT_COUNT];  // Latest frame read back
+	Uint64 total[PIPELINE_STAT_COUNT]; // Every frame read back
+	Uint64 counted;                    // Frames read back
+} PipelineStats;
+
+// Create pipeline statistics, with their queries if they are supported.
+PipelineStats *CreatePipelineStats(void);
+
+// Delete the statistics' query objects.
+void DestroyPipelineStats(PipelineStats *stats);
+
+/**
+ * Read back the counts of GPU_TIMER_FRAMES frames ago, if they are ready, and
+ * start counting this frame. Can't be nested with a FragmentCounter, which
+ * may use fragment shader invocations too.
+ */
+void BeginPipelineStats(PipelineStats *stats);
+
+// Stop counting this frame.
+void EndPipelineStats(PipelineStats *stats);
+
+// Print the last and average count per frame of every statistic, and their
+// ratios.
+void PrintPipelineStats(const PipelineStats *stats);
+
+/**
+ * Samples passed (fragments surviving the depth test) in one part of every
+ * frame, read back GPU_TIMER_FRAMES frames later like GPUTimer, so counting
+ * never stalls. A frame whose result isn't ready by then is dropped.
+ */
+typedef struct SampleCounter {
+	unsigned int queries[GPU_TIMER_FRAMES];
+	bool issued[GPU_TIMER_FRAMES];
+	int frame; // Query used this frame
+	Uint64 frames;
+	Uint64 dropped; // Frames whose result wasn't ready in time
+	Uint64 last;    // Latest result read back
+} SampleCounter;
+
+// Create a sample counter and its queries.
+SampleCounter *CreateSampleCounter(void);
+
+// Delete the counter's query objects.
+void DestroySampleCounter(SampleCounter *counter);
+
+/**
+ * Read back the count of GPU_TIMER_FRAMES frames ago into `last`, if it is
+ * ready, and start counting this frame's samples. Counts can't be nested
+ * with other GL_SAMPLES_PASSED queries, e.g. a FragmentCounter's.
+ */
+void BeginSampleCount(SampleCounter *counter);
+
+// Stop counting this frame's samples.
+void EndSampleCount(SampleCounter *counter);
+
+// Render passes timed on the GPU, in the order they are drawn
+typedef enum GPUPass {
+	GPU_PASS_CLEAR,
+	GPU_PASS_FRACTAL,
+	GPU_PASS_OVERLAY,
+	GPU_PASS_COUNT
+} GPUPass;
+
+/**
+ * GPU time of each render pass, from GL_TIMESTAMP queries issued before and
+ * after it.
+ *
+ * Every frame uses its own set of queries, and a set is only read back
+ * GPU_TIMER_FRAMES frames later, when it is reused. Results are never waited
+ * for: if the GPU is still further behind, that frame's times are dropped
+ * rather than stalling the pipeline. Read-back times are recorded into the
+ * `gpu *` stages of timing.h, next to the CPU stages.
+ *
+ * Needs ARB_timer_query (core in GL 3.3, llvmpipe has it). Without it
+ * `available` is false and the timer does nothing.
+ */
+typedef struct GPUTimer {
+	bool available;
+	unsigned int queries[GPU_TIMER_FRAMES][GPU_PASS_COUNT][2];
+	bool issued[GPU_TIMER_FRAMES][GPU_PASS_COUNT];
+	int frame; // Set of queries used this frame
+	Uint64 frames;
+	Uint64 dropped; // Frames whose results weren't ready in time
+} GPUTimer;
+
+// Create a GPU timer, with its queries if timer queries are supported.
+GPUTimer *CreateGPUTimer(void);
+
+// Delete the timer's query objects.
+void DestroyGPUTimer(GPUTimer *timer);
+
+/**
+ * Record the times of the frame GPU_TIMER_FRAMES ago and reuse its queries
+ * for this one. Call once per frame before any pass.
+ */
+void BeginGPUFrame(GPUTimer *timer);
+
+// Mark the start of `pass` in the command stream.
+void BeginGPUPass(GPUTimer *timer, GPUPass pass);
+
+// Mark the end of `pass` in the command stream.
+void EndGPUPass(GPUTimer *timer, GPUPass pass);
+
+#endif // QUERY_H
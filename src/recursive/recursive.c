@@ -0,0 +1,187 @@
+#include "recursive/recursive.h"
+
+#include <glad/glad.h>
+#include <stdio.h>
+
+#include "leaves/leaves.h"
+#include "memory/memory.h"
+#include "mesh/mesh.h"
+#include "query/query.h"
+#include "vertices.h"
+
+RecursiveRenderer *CreateRecursiveRenderer(void) {
+	RecursiveRenderer *renderer = (RecursiveRenderer *)TaggedCalloc(
+	    MEMORY_APP, 1, sizeof(RecursiveRenderer));
+	if (renderer == NULL) {
+		perror("Could not allocate memory for recursive renderer");
+		return NULL;
+	}
+
+	// Copy the vertex data to the GPU for OpenGL
+	glGenBuffers(1, &renderer->vbo);
+	glBindBuffer(GL_ARRAY_BUFFER, renderer->vbo);
+	PackedVertex packed_triangle[18];
+	PackVertices(triangle, 18, packed_triangle);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(packed_triangle), packed_triangle,
+	             GL_STATIC_DRAW);
+	TrackGPUMemory(MEMORY_APP, GPU_OBJECT_BUFFER, renderer->vbo,
+	               sizeof(packed_triangle));
+
+	glGenVertexArrays(1, &renderer->vao);
+	glBindVertexArray(renderer->vao);
+
+	SetupPackedVertexAttributes();
+
+	renderer->program = LoadShaderProgram("shader.vert", "shader.frag");
+	if (renderer->program == NULL) {
+		DestroyRecursiveRenderer(renderer);
+		return NULL;
+	}
+	renderer->model_uniform = glGetUniformLocation(*renderer->program, "model");
+	renderer->view_uniform = glGetUniformLocation(*renderer->program, "view");
+	renderer->perspective_uniform =
+	    glGetUniformLocation(*renderer->program, "perspective");
+
+	return renderer;
+}
+
+void DestroyRecursiveRenderer(RecursiveRenderer *renderer) {
+	if (renderer->program != NULL) {
+		DeleteShaderProgram(renderer->program);
+	}
+	glDeleteVertexArrays(1, &renderer->vao);
+	ReleaseGPUMemory(GPU_OBJECT_BUFFER, renderer->vbo);
+	glDeleteBuffers(1, &renderer->vbo);
+	TaggedFree(renderer);
+}
+
+void UseRecursiveRenderer(RecursiveRenderer *renderer, mat4 view,
+                          mat4 perspective) {
+	UseShaderProgram(renderer->program);
+	glBindVertexArray(renderer->vao);
+	glUniformMatrix4fv(renderer->view_uniform, 1, GL_FALSE, (float *)view);
+	glUniformMatrix4fv(renderer->perspective_uniform, 1, GL_FALSE,
+	                   (float *)perspective);
+}
+
+void DrawRecursive(RecursiveRenderer *renderer, int depth, mat4 view,
+                   mat4 perspective, const float *eye) {
+	// The recursion is the traversal, interleaved with the draws
+	UseRecursiveRenderer(renderer, view, perspective);
+	draw_serpinskis_triangle((vec3){0.0, 0.5, 0.0}, depth, 1.0,
+	                         renderer->model_uniform, eye);
+}
+
+void draw_triangle(vec3 top, float scale, unsigned int uniform_loc) {
+	vec3 center = {top[0], (top[1] - (0.5f * scale)), top[2]};
+
+	mat4 model = GLM_MAT4_IDENTITY_INIT;
+	glm_translate(model, center);
+	glm_scale(model, (vec3){scale, scale, scale});
+
+	glUniformMatrix4fv(uniform_loc, 1, GL_FALSE, (float *)model);
+	glDrawArrays(GL_TRIANGLES, 0, 18);
+}
+
+void draw_serpinskis_triangle(vec3 top, int subdivide, float scale,
+                              unsigned int uniform_loc, const float *eye) {
+	if (subdivide <= 0) { // Base case
+		draw_triangle(top, scale, uniform_loc);
+		return;
+	}
+
+	subdivide--;
+
+	/**
+	 *         top
+	 *          ^
+	 *         / \
+	 *        /   \
+	 * mid1  *     *  mid2
+	 *      /       \
+	 *     /         \
+	 * bl /_____*_____\  br
+	 *         mid3
+	 *
+	 */
+
+	vec3 mid_lf, mid_lb, mid_rf, mid_rb;
+	vec3 base_center;
+
+	float *corners[] = {mid_rf, mid_rb, mid_lb, mid_lf};
+
+	vec3 translations[] = {
+	    {0.5, -1.0, 0.5},
+	    {0.5, -1.0, -0.5},
+	    {-0.5, -1.0, -0.5},
+	    {-0.5, -1.0, 0.5},
+	};
+
+	// Rotates from right-front, right-back, left-back, and left-front.
+	scale *= 0.5f;
+	for (int i = 0; i < 4; i++) {
+		glm_vec3_scale(translations[i], scale, translations[i]);
+		glm_vec3_add(top, translations[i], corners[i]);
+	}
+
+	glm_vec3_add(mid_lf, mid_rb, base_center);
+	glm_vec3_divs(base_center, 2.0f, base_center);
+
+	float *children[] = {top, mid_lf, mid_lb, mid_rf, mid_rb};
+
+	static const int fixed_order[] = {0, 1, 2, 3, 4};
+	const int *order = fixed_order;
+	if (eye != NULL) {
+		// Center of this (unsubdivided) pyramid, the scale was halved above
+		vec3 center = {top[0], top[1] - scale, top[2]};
+		order = LeafChildOrder(center, eye);
+	}
+
+	for (int i = 0; i < 5; i++) {
+		draw_serpinskis_triangle(children[order[i]], subdivide, scale,
+		                         uniform_loc, eye);
+	}
+
+	return;
+}
+
+void benchmark_draw_order(int subdivide, unsigned int uniform_loc,
+                          const float *eye) {
+	const int frames = 20;
+
+	FragmentCounter *counter = CreateFragmentCounter();
+	if (counter == NULL) {
+		return;
+	}
+
+	printf("Draw order benchmark at depth %d (%d frames each)\n", subdivide,
+	       frames);
+	printf("%14s %28s %10s\n", "order", counter->name, "ms/frame");
+
+	for (int i = 0; i < 2; i++) {
+		const float *order_eye = (i == 1) ? eye : NULL;
+
+		glFinish();
+		Uint64 start = SDL_GetTicksNS();
+		for (int f = 0; f < frames; f++) {
+			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+			draw_serpinskis_triangle((vec3){0.0, 0.5, 0.0}, subdivide, 1.0,
+			                         uniform_loc, order_eye);
+		}
+		glFinish();
+		Uint64 elapsed = SDL_GetTicksNS() - start;
+
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+		BeginFragmentCount(counter);
+		draw_serpinskis_triangle((vec3){0.0, 0.5, 0.0}, subdivide, 1.0,
+		                         uniform_loc, order_eye);
+		Uint64 fragments = EndFragmentCount(counter);
+
+		printf("%14s %28llu %10.3f\n",
+		       order_eye != NULL ? "front-to-back" : "fixed",
+		       (unsigned long long)fragments,
+		       (double)elapsed / 1e6 / frames);
+	}
+
+	DestroyFragmentCounter(counter);
+}
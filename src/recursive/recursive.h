@@ -0,0 +1,69 @@
+#ifndef RECURSIVE_H
+#define RECURSIVE_H
+
+#include <cglm/cglm.h>
+
+#include "shaders/shader.h"
+
+/**
+ * The reference render path: the base pyramid from vertices.h, drawn once
+ * per leaf by draw_serpinskis_triangle with its own model matrix.
+ */
+typedef struct RecursiveRenderer {
+	unsigned int vbo; // The base pyramid, packed (see mesh.h)
+	unsigned int vao;
+	ShaderProgram *program;
+	unsigned int model_uniform;
+	unsigned int view_uniform;
+	unsigned int perspective_uniform;
+} RecursiveRenderer;
+
+// Upload the base pyramid and load its shaders.
+RecursiveRenderer *CreateRecursiveRenderer(void);
+
+// Free the renderer and its GL objects.
+void DestroyRecursiveRenderer(RecursiveRenderer *renderer);
+
+/**
+ * Bind the renderer's program and VAO and set the camera uniforms, for the
+ * functions below that only take the model uniform.
+ */
+void UseRecursiveRenderer(RecursiveRenderer *renderer, mat4 view,
+                          mat4 perspective);
+
+/**
+ * Draw the pyramid subdivided `depth` times, front to back from `eye` or in
+ * the fixed order if it is NULL.
+ */
+void DrawRecursive(RecursiveRenderer *renderer, int depth, mat4 view,
+                   mat4 perspective, const float *eye);
+
+// Used to draw a traingle.
+void draw_triangle(vec3 top, float scale, unsigned int uniform_loc);
+
+/**
+ * Draw Serpinski's traingle.
+ *
+ * `top`, `bottom_left`, `bottom_right` are the coordinates of the triangle to
+ * draw.
+ *
+ * `subdivide` indicates whether the traingle should be divided using recursion.
+ *
+ * `uniform_loc` is the location of the transform's uniform in the shader
+ * program.
+ *
+ * `eye` is the camera position to draw the triangles front to back from, or
+ * `NULL` to draw them in the fixed order (top, lf, lb, rf, rb).
+ *
+ * Note: this assumes the correct shader program has been loaded and the
+ * uniforms have been setup properly.
+ */
+void draw_serpinskis_triangle(vec3 top, int subdivide, float scale,
+                              unsigned int uniform_loc, const float *eye);
+
+// Time the recursive draw in the fixed and front-to-back orders and print
+// the frame time and fragment count of each.
+void benchmark_draw_order(int subdivide, unsigned int uniform_loc,
+                          const float *eye);
+
+#endif // RECURSIVE_H
@@ -0,0 +1,175 @@
+#include "ring/ring.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "glext/glext.h"
+#include "memory/memory.h"
+
+// How long a single glClientWaitSync may block before trying again, in ns
+#define RING_WAIT_TIMEOUT 1000000
+
+// (Re)create the buffer with `region_size` bytes per region.
+static bool create_storage(RingBuffer *ring, size_t region_size) {
+	size_t total = region_size * RING_REGIONS;
+
+	glGenBuffers(1, &ring->buffer);
+	glBindBuffer(ring->target, ring->buffer);
+
+	if (ring->persistent) {
+		GLbitfield flags =
+		    GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		glBufferStorage(ring->target, total, NULL, flags);
+		ring->mapped = (unsigned char *)glMapBufferRange(ring->target, 0,
+		                                                 total, flags);
+		if (ring->mapped == NULL) {
+			printf("Could not persistently map ring buffer\n");
+			glDeleteBuffers(1, &ring->buffer);
+			return false;
+		}
+	} else {
+		glBufferData(ring->target, total, NULL, GL_STREAM_DRAW);
+	}
+	TrackGPUMemory(MEMORY_CULLING, GPU_OBJECT_BUFFER, ring->buffer, total);
+
+	ring->region_size = region_size;
+	return true;
+}
+
+// Block until a fence has signalled, counting the stall if it hadn't yet.
+static void wait_fence(RingBuffer *ring, GLsync fence) {
+	GLenum status = glClientWaitSync(fence, 0, 0);
+	if (status == GL_TIMEOUT_EXPIRED) {
+		Uint64 start = SDL_GetTicksNS();
+		do {
+			status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT,
+			                          RING_WAIT_TIMEOUT);
+		} while (status == GL_TIMEOUT_EXPIRED);
+		ring->stalls++;
+		ring->stall_ns += SDL_GetTicksNS() - start;
+	}
+	glDeleteSync(fence);
+}
+
+// Grow the buffer so a region fits `size` bytes. Everything in flight is
+// waited on first, and the current frame restarts at the first region.
+static bool grow(RingBuffer *ring, size_t size) {
+	for (int i = 0; i < RING_REGIONS; i++) {
+		if (ring->fences[i] != NULL) {
+			wait_fence(ring, ring->fences[i]);
+			ring->fences[i] = NULL;
+		}
+	}
+
+	glBindBuffer(ring->target, ring->buffer);
+	if (ring->persistent) {
+		glUnmapBuffer(ring->target);
+		ring->mapped = NULL;
+	}
+	ReleaseGPUMemory(GPU_OBJECT_BUFFER, ring->buffer);
+	glDeleteBuffers(1, &ring->buffer);
+
+	size_t region_size = ring->region_size * 2;
+	while (region_size < size) {
+		region_size *= 2;
+	}
+
+	ring->region = 0;
+	ring->offset = 0;
+	ring->resizes++;
+	if (!create_storage(ring, region_size)) {
+		// As in CreateRingBuffer, fall back to mapping every allocation
+		ring->persistent = false;
+		return create_storage(ring, region_size);
+	}
+	return true;
+}
+
+RingBuffer *CreateRingBuffer(GLenum target, size_t region_size) {
+	RingBuffer *ring =
+	    (RingBuffer *)TaggedCalloc(MEMORY_CULLING, 1, sizeof(RingBuffer));
+	if (ring == NULL) {
+		perror("Could not allocate memory for ring buffer");
+		return NULL;
+	}
+
+	ring->target = target;
+	ring->persistent = gl_extensions.buffer_storage;
+
+	if (!create_storage(ring, region_size)) {
+		// Persistent mapping failed, fall back to mapping every allocation
+		ring->persistent = false;
+		if (!create_storage(ring, region_size)) {
+			TaggedFree(ring);
+			return NULL;
+		}
+	}
+
+	return ring;
+}
+
+void DestroyRingBuffer(RingBuffer *ring) {
+	for (int i = 0; i < RING_REGIONS; i++) {
+		if (ring->fences[i] != NULL) {
+			glDeleteSync(ring->fences[i]);
+		}
+	}
+
+	glBindBuffer(ring->target, ring->buffer);
+	if (ring->mapped != NULL || ring->map_pending) {
+		glUnmapBuffer(ring->target);
+	}
+	ReleaseGPUMemory(GPU_OBJECT_BUFFER, ring->buffer);
+	glDeleteBuffers(1, &ring->buffer);
+	TaggedFree(ring);
+}
+
+void BeginRingFrame(RingBuffer *ring) {
+	ring->region = (ring->region + 1) % RING_REGIONS;
+	ring->offset = 0;
+	ring->frames++;
+
+	if (ring->fences[ring->region] != NULL) {
+		wait_fence(ring, ring->fences[ring->region]);
+		ring->fences[ring->region] = NULL;
+	}
+}
+
+void *AllocateRing(RingBuffer *ring, size_t size, size_t alignment,
+                   size_t *offset) {
+	size_t start = (ring->offset + alignment - 1) / alignment * alignment;
+	if (start + size > ring->region_size) {
+		if (!grow(ring, size)) {
+			return NULL;
+		}
+		start = 0;
+	}
+
+	ring->offset = start + size;
+	*offset = ring->region * ring->region_size + start;
+
+	glBindBuffer(ring->target, ring->buffer);
+	if (ring->persistent) {
+		return ring->mapped + *offset;
+	}
+
+	void *data = glMapBufferRange(ring->target, *offset, size,
+	                              GL_MAP_WRITE_BIT |
+	                                  GL_MAP_INVALIDATE_RANGE_BIT |
+	                                  GL_MAP_UNSYNCHRONIZED_BIT);
+	ring->map_pending = data != NULL;
+	return data;
+}
+
+void CommitRing(RingBuffer *ring) {
+	if (ring->map_pending) {
+		glBindBuffer(ring->target, ring->buffer);
+		glUnmapBuffer(ring->target);
+		ring->map_pending = false;
+	}
+}
+
+void EndRingFrame(RingBuffer *ring) {
+	ring->fences[ring->region] =
+	    glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
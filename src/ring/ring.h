@@ -0,0 +1,78 @@
+#ifndef RING_H
+#define RING_H
+
+#include <SDL3/SDL.h>
+#include <glad/glad.h>
+
+// Number of regions in a ring, i.e. frames that can be in flight at once.
+#define RING_REGIONS 3
+
+/**
+ * Ring allocator for data streamed to the GPU every frame.
+ *
+ * The buffer is split into RING_REGIONS regions and each frame writes into
+ * the next one. A fence is placed after the frame's draws, and a region is
+ * only reused once its fence has signalled, so in-flight data is never
+ * overwritten and the buffer is never re-specified.
+ *
+ * With buffer storage the whole buffer is persistently and coherently
+ * mapped once. Otherwise each allocation is mapped unsynchronized (the
+ * fences already provide the synchronization) and must be committed with
+ * CommitRing before it is used.
+ */
+typedef struct RingBuffer {
+	GLenum target;
+	unsigned int buffer;
+	bool persistent;
+	unsigned char *mapped; // Persistent mapping of the whole buffer
+
+	size_t region_size;
+	int region;    // Region written this frame
+	size_t offset; // Next free byte within the region
+	GLsync fences[RING_REGIONS];
+
+	bool map_pending; // A non-persistent mapping waits for CommitRing
+
+	// Statistics
+	Uint64 frames;
+	Uint64 stalls;   // Frames that had to wait for the GPU
+	Uint64 stall_ns; // Total time spent waiting
+	Uint64 resizes;  // Times the buffer grew to fit an allocation
+} RingBuffer;
+
+/**
+ * Create a ring for `target` (e.g. GL_DRAW_INDIRECT_BUFFER) with
+ * `region_size` bytes per frame. The ring grows if a frame needs more.
+ */
+RingBuffer *CreateRingBuffer(GLenum target, size_t region_size);
+
+// Delete the ring's buffer and fences.
+void DestroyRingBuffer(RingBuffer *ring);
+
+/**
+ * Move on to the next region, waiting for the GPU to be done with it.
+ *
+ * Call once per frame before any AllocateRing.
+ */
+void BeginRingFrame(RingBuffer *ring);
+
+/**
+ * Reserve `size` bytes in this frame's region, aligned to `alignment`.
+ *
+ * Returns a pointer to write the data to, and the byte offset of the data
+ * in the ring's buffer in `offset`. The buffer is left bound to the ring's
+ * target. Returns NULL if the buffer couldn't be mapped.
+ *
+ * If the region is too small the ring grows, which invalidates earlier
+ * allocations from this frame that haven't been drawn with yet.
+ */
+void *AllocateRing(RingBuffer *ring, size_t size, size_t alignment,
+                   size_t *offset);
+
+// Make the last allocation visible to the GPU. Call before drawing with it.
+void CommitRing(RingBuffer *ring);
+
+// Fence this frame's region. Call after the draws that read from it.
+void EndRingFrame(RingBuffer *ring);
+
+#endif // RING_H
@@ -4,6 +4,9 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include "memory/memory.h"
+#include "trace/trace.h"
+
 #define INFO_LOG_SIZE 512
 
 static int gl_success;
@@ -23,7 +26,7 @@ Shader *LoadShader(const char *path, GLenum type)
     long fsize = ftell(file);
     rewind(file);
 
-    char *buffer = (char *)malloc(fsize + 1);
+    char *buffer = (char *)TaggedMalloc(MEMORY_SHADERS, fsize + 1);
     if (buffer == NULL)
     {
         perror("Could not allocate memory for buffer");
@@ -35,26 +38,28 @@ Shader *LoadShader(const char *path, GLenum type)
 
     buffer[fsize] = 0;
 
-    Shader *shader = (Shader *)malloc(sizeof(Shader));
+    Shader *shader = (Shader *)TaggedMalloc(MEMORY_SHADERS, sizeof(Shader));
     if (shader == NULL)
     {
         perror("Could not allocate memory for shader");
-        free(buffer);
+        TaggedFree(buffer);
         return NULL;
     }
     *shader = glCreateShader(type);
     glShaderSource(*shader, 1, (const char *const *)&buffer, NULL);
+    TraceBegin("glCompileShader");
     glCompileShader(*shader);
 
-    free(buffer);
+    TaggedFree(buffer);
 
     // Check if the shader compiled without errors
     glGetShaderiv(*shader, GL_COMPILE_STATUS, &gl_success);
+    TraceEnd("glCompileShader");
     if (!gl_success)
     {
         glGetShaderInfoLog(*shader, INFO_LOG_SIZE, NULL, info_log);
         printf("Could not compile shader: %s\n", info_log);
-        free(shader);
+        TaggedFree(shader);
         return NULL;
     }
 
@@ -64,12 +69,13 @@ Shader *LoadShader(const char *path, GLenum type)
 void DeleteShader(Shader *shader)
 {
     glDeleteShader(*shader);
-    free(shader);
+    TaggedFree(shader);
 }
 
 ShaderProgram *CreateShaderProgram(Shader *vert, Shader *frag)
 {
-    ShaderProgram *program = (ShaderProgram *)malloc(sizeof(ShaderProgram));
+    ShaderProgram *program =
+        (ShaderProgram *)TaggedMalloc(MEMORY_SHADERS, sizeof(ShaderProgram));
     if (program == NULL)
     {
         perror("Could not allocate memory for shader program");
@@ -78,14 +84,16 @@ ShaderProgram *CreateShaderProgram(Shader *vert, Shader *frag)
     *program = glCreateProgram();
     glAttachShader(*program, *vert);
     glAttachShader(*program, *frag);
+    TraceBegin("glLinkProgram");
     glLinkProgram(*program);
 
     glGetShaderiv(*program, GL_LINK_STATUS, &gl_success);
+    TraceEnd("glLinkProgram");
     if (!gl_success)
     {
         glGetShaderInfoLog(*program, INFO_LOG_SIZE, NULL, info_log);
         printf("Could not compile shader: %s\n", info_log);
-        free(program);
+        TaggedFree(program);
         return NULL;
     }
 
@@ -94,10 +102,13 @@ ShaderProgram *CreateShaderProgram(Shader *vert, Shader *frag)
 
 ShaderProgram *LoadShaderProgram(const char *vert, const char *frag)
 {
+    TraceBegin("LoadShaderProgram");
+
     Shader *vertex_shader = LoadShader(vert, GL_VERTEX_SHADER);
     if (vertex_shader == NULL)
     {
         printf("Could not load vertex shader!\n");
+        TraceEnd("LoadShaderProgram");
         return NULL;
     }
 
@@ -106,6 +117,7 @@ ShaderProgram *LoadShaderProgram(const char *vert, const char *frag)
     {
         printf("Could not load fragment shader!\n");
         DeleteShader(vertex_shader);
+        TraceEnd("LoadShaderProgram");
         return NULL;
     }
 
@@ -118,6 +130,7 @@ ShaderProgram *LoadShaderProgram(const char *vert, const char *frag)
     DeleteShader(vertex_shader);
     DeleteShader(fragment_shader);
 
+    TraceEnd("LoadShaderProgram");
     return program;
 }
 
@@ -129,5 +142,5 @@ void UseShaderProgram(ShaderProgram *program)
 void DeleteShaderProgram(ShaderProgram *program)
 {
     glDeleteProgram(*program);
-    free(program);
+    TaggedFree(program);
 }
@@ -0,0 +1,401 @@
+#include "splat/splat.h"
+
+#include <glad/glad.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "memory/memory.h"
+#include "trace/trace.h"
+
+// Iterations thrown away before a worker starts splatting. Every step halves
+// the distance to the attractor, so after this many the error is sub-pixel.
+#define SPLAT_BURN_IN 32
+
+enum SplatPhase {
+	SPLAT_PHASE_ACCUMULATE,
+	SPLAT_PHASE_MERGE,
+	SPLAT_PHASE_TONEMAP,
+	SPLAT_PHASE_QUIT,
+};
+
+struct SplatWorker {
+	Splatter *splatter;
+	SDL_Thread *thread;
+	SDL_Semaphore *start;
+	int index;
+	Uint64 seed;
+	Uint32 max_density; // Largest merged bin in this worker's rows
+};
+
+// The five corners of the base pyramid, the targets of the chaos game.
+static const float pyramid_corners[5][3] = {
+    {0.0f, 0.5f, 0.0f},    // top
+    {-0.5f, -0.5f, 0.5f},  // left_front
+    {-0.5f, -0.5f, -0.5f}, // left_back
+    {0.5f, -0.5f, 0.5f},   // right_front
+    {0.5f, -0.5f, -0.5f},  // right_back
+};
+
+static inline Uint64 xorshift64(Uint64 *state) {
+	Uint64 x = *state;
+	x ^= x << 13;
+	x ^= x >> 7;
+	x ^= x << 17;
+	*state = x;
+	return x;
+}
+
+/**
+ * Play the chaos game directly in clip space.
+ *
+ * The projection is linear in homogeneous coordinates, so the midpoint of two
+ * world-space points maps to the midpoint of their clip-space positions. That
+ * leaves a 4-wide lerp and one divide per point instead of a full matrix
+ * transform.
+ */
+static void accumulate(SplatWorker *worker) {
+	Splatter *splatter = worker->splatter;
+	const int width = splatter->width;
+	const int height = splatter->height;
+	const float half_w = 0.5f * (float)width;
+	const float half_h = 0.5f * (float)height;
+
+	Uint32 *histogram =
+	    splatter->histograms + (size_t)worker->index * width * height;
+	memset(histogram, 0, sizeof(Uint32) * width * height);
+
+	Uint64 count = splatter->num_points / splatter->num_threads;
+	if (worker->index == 0) {
+		count += splatter->num_points % splatter->num_threads;
+	}
+
+	float v[5][4];
+	memcpy(v, splatter->clip_vertices, sizeof(v));
+
+	// Start from the apex so every point is on the attractor from the first
+	// step.
+	float x = v[0][0], y = v[0][1], z = v[0][2], w = v[0][3];
+
+	// Fixed seeds keep the image stable between re-accumulations.
+	Uint64 rng = worker->seed;
+
+	for (int i = 0; i < SPLAT_BURN_IN; i++) {
+		Uint32 c = (Uint32)(((xorshift64(&rng) >> 32) * 5) >> 32);
+		x = 0.5f * (x + v[c][0]);
+		y = 0.5f * (y + v[c][1]);
+		z = 0.5f * (z + v[c][2]);
+		w = 0.5f * (w + v[c][3]);
+	}
+
+	for (Uint64 i = 0; i < count; i += 2) {
+		// Each 64-bit draw picks two corners.
+		Uint64 r = xorshift64(&rng);
+		Uint32 picks[2] = {(Uint32)(((r >> 32) * 5) >> 32),
+		                   (Uint32)(((r & 0xffffffffu) * 5) >> 32)};
+
+		for (int j = 0; j < 2; j++) {
+			const float *t = v[picks[j]];
+			x = 0.5f * (x + t[0]);
+			y = 0.5f * (y + t[1]);
+			z = 0.5f * (z + t[2]);
+			w = 0.5f * (w + t[3]);
+
+			// Reject anything outside the near/far planes.
+			if (z < -w || z > w) {
+				continue;
+			}
+
+			float inv_w = 1.0f / w;
+			int px = (int)((x * inv_w + 1.0f) * half_w);
+			int py = (int)((y * inv_w + 1.0f) * half_h);
+			if ((unsigned)px < (unsigned)width &&
+			    (unsigned)py < (unsigned)height) {
+				histogram[py * width + px]++;
+			}
+		}
+	}
+}
+
+// Returns the band of rows [first, last) owned by a worker.
+static void worker_rows(SplatWorker *worker, int *first, int *last) {
+	Splatter *splatter = worker->splatter;
+	int band = (splatter->height + splatter->num_threads - 1) /
+	           splatter->num_threads;
+	*first = worker->index * band;
+	*last = *first + band;
+	if (*first > splatter->height) {
+		*first = splatter->height;
+	}
+	if (*last > splatter->height) {
+		*last = splatter->height;
+	}
+}
+
+// Sum every thread's histogram into the first one, for this worker's rows.
+static void merge(SplatWorker *worker) {
+	Splatter *splatter = worker->splatter;
+	size_t pixels = (size_t)splatter->width * splatter->height;
+
+	int first, last;
+	worker_rows(worker, &first, &last);
+	size_t begin = (size_t)first * splatter->width;
+	size_t end = (size_t)last * splatter->width;
+
+	Uint32 *total = splatter->histograms;
+	for (int t = 1; t < splatter->num_threads; t++) {
+		const Uint32 *histogram = splatter->histograms + t * pixels;
+		for (size_t i = begin; i < end; i++) {
+			total[i] += histogram[i];
+		}
+	}
+
+	Uint32 max_density = 0;
+	for (size_t i = begin; i < end; i++) {
+		if (total[i] > max_density) {
+			max_density = total[i];
+		}
+	}
+	worker->max_density = max_density;
+}
+
+// Map merged densities to bytes with log(1 + n) / log(1 + max).
+static void tonemap(SplatWorker *worker) {
+	Splatter *splatter = worker->splatter;
+
+	int first, last;
+	worker_rows(worker, &first, &last);
+	size_t begin = (size_t)first * splatter->width;
+	size_t end = (size_t)last * splatter->width;
+
+	float scale = 0.0f;
+	if (splatter->max_density > 0) {
+		scale = 255.0f / logf(1.0f + (float)splatter->max_density);
+	}
+
+	const Uint32 *total = splatter->histograms;
+	for (size_t i = begin; i < end; i++) {
+		splatter->image[i] = (Uint8)(logf(1.0f + (float)total[i]) * scale);
+	}
+}
+
+static int worker_main(void *data) {
+	SplatWorker *worker = (SplatWorker *)data;
+	Splatter *splatter = worker->splatter;
+
+	char name[TRACE_THREAD_NAME_SIZE];
+	snprintf(name, sizeof(name), "splat %d", worker->index);
+	TraceThreadName(name);
+
+	for (;;) {
+		SDL_WaitSemaphore(worker->start);
+
+		switch (splatter->phase) {
+		case SPLAT_PHASE_ACCUMULATE:
+			TraceBegin("accumulate");
+			accumulate(worker);
+			TraceEnd("accumulate");
+			break;
+		case SPLAT_PHASE_MERGE:
+			TraceBegin("merge");
+			merge(worker);
+			TraceEnd("merge");
+			break;
+		case SPLAT_PHASE_TONEMAP:
+			TraceBegin("tonemap");
+			tonemap(worker);
+			TraceEnd("tonemap");
+			break;
+		case SPLAT_PHASE_QUIT:
+			return 0;
+		}
+
+		SDL_SignalSemaphore(splatter->done);
+	}
+}
+
+// Run one phase on every worker and wait for all of them to finish.
+static void run_phase(Splatter *splatter, int phase) {
+	splatter->phase = phase;
+	for (int i = 0; i < splatter->num_threads; i++) {
+		SDL_SignalSemaphore(splatter->workers[i].start);
+	}
+	for (int i = 0; i < splatter->num_threads; i++) {
+		SDL_WaitSemaphore(splatter->done);
+	}
+}
+
+/**
+ * Stop the first `started` workers and destroy every semaphore created so
+ * far. Workers exit without signalling `done`, so they're only woken up.
+ */
+static void stop_workers(Splatter *splatter, int started) {
+	splatter->phase = SPLAT_PHASE_QUIT;
+	for (int i = 0; i < started; i++) {
+		SDL_SignalSemaphore(splatter->workers[i].start);
+	}
+	for (int i = 0; i < started; i++) {
+		SDL_WaitThread(splatter->workers[i].thread, NULL);
+	}
+	for (int i = 0; i < splatter->num_threads; i++) {
+		if (splatter->workers[i].start != NULL) {
+			SDL_DestroySemaphore(splatter->workers[i].start);
+		}
+	}
+	if (splatter->done != NULL) {
+		SDL_DestroySemaphore(splatter->done);
+	}
+}
+
+// Free the CPU buffers and the splatter itself.
+static void free_buffers(Splatter *splatter) {
+	TaggedFree(splatter->histograms);
+	TaggedFree(splatter->image);
+	TaggedFree(splatter->workers);
+	TaggedFree(splatter);
+}
+
+Splatter *CreateSplatter(int width, int height, Uint64 num_points) {
+	Splatter *splatter =
+	    (Splatter *)TaggedCalloc(MEMORY_SPLAT, 1, sizeof(Splatter));
+	if (splatter == NULL) {
+		perror("Could not allocate memory for splatter");
+		return NULL;
+	}
+
+	splatter->width = width;
+	splatter->height = height;
+	splatter->num_points = num_points;
+	splatter->num_threads = SDL_GetNumLogicalCPUCores();
+	if (splatter->num_threads < 1) {
+		splatter->num_threads = 1;
+	}
+
+	size_t pixels = (size_t)width * height;
+	splatter->histograms = (Uint32 *)TaggedMalloc(
+	    MEMORY_SPLAT, sizeof(Uint32) * pixels * splatter->num_threads);
+	splatter->image = (Uint8 *)TaggedMalloc(MEMORY_SPLAT, pixels);
+	splatter->workers = (SplatWorker *)TaggedCalloc(
+	    MEMORY_SPLAT, splatter->num_threads, sizeof(SplatWorker));
+	if (splatter->histograms == NULL || splatter->image == NULL ||
+	    splatter->workers == NULL) {
+		perror("Could not allocate memory for splat buffers");
+		free_buffers(splatter);
+		return NULL;
+	}
+
+	splatter->done = SDL_CreateSemaphore(0);
+	if (splatter->done == NULL) {
+		printf("Could not create the splat semaphore: %s\n", SDL_GetError());
+		free_buffers(splatter);
+		return NULL;
+	}
+	for (int i = 0; i < splatter->num_threads; i++) {
+		SplatWorker *worker = &splatter->workers[i];
+		worker->splatter = splatter;
+		worker->index = i;
+		worker->seed = 0x9E3779B97F4A7C15ULL * (Uint64)(i + 1);
+		worker->start = SDL_CreateSemaphore(0);
+		if (worker->start != NULL) {
+			worker->thread = SDL_CreateThread(worker_main, "splat", worker);
+		}
+		if (worker->thread == NULL) {
+			printf("Could not start splat worker %d: %s\n", i,
+			       SDL_GetError());
+			stop_workers(splatter, i);
+			free_buffers(splatter);
+			return NULL;
+		}
+	}
+
+	// Density texture and an empty VAO for the full-screen triangle
+	glGenTextures(1, &splatter->texture);
+	glBindTexture(GL_TEXTURE_2D, splatter->texture);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, width, height, 0, GL_RED,
+	             GL_UNSIGNED_BYTE, NULL);
+	TrackGPUMemory(MEMORY_SPLAT, GPU_OBJECT_TEXTURE, splatter->texture, pixels);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+	glGenVertexArrays(1, &splatter->vao);
+
+	splatter->program = LoadShaderProgram("splat.vert", "splat.frag");
+
+	return splatter;
+}
+
+void DestroySplatter(Splatter *splatter) {
+	stop_workers(splatter, splatter->num_threads);
+
+	if (splatter->program != NULL) {
+		DeleteShaderProgram(splatter->program);
+	}
+	glDeleteVertexArrays(1, &splatter->vao);
+	ReleaseGPUMemory(GPU_OBJECT_TEXTURE, splatter->texture);
+	glDeleteTextures(1, &splatter->texture);
+
+	free_buffers(splatter);
+}
+
+bool UpdateSplatter(Splatter *splatter, mat4 view_proj) {
+	if (splatter->valid && memcmp(splatter->last_view_proj, view_proj,
+	                              sizeof(mat4)) == 0) {
+		return false;
+	}
+
+	Uint64 start = SDL_GetTicksNS();
+
+	for (int i = 0; i < 5; i++) {
+		vec4 corner = {pyramid_corners[i][0], pyramid_corners[i][1],
+		               pyramid_corners[i][2], 1.0f};
+		glm_mat4_mulv(view_proj, corner, splatter->clip_vertices[i]);
+	}
+
+	run_phase(splatter, SPLAT_PHASE_ACCUMULATE);
+	run_phase(splatter, SPLAT_PHASE_MERGE);
+
+	splatter->max_density = 0;
+	for (int i = 0; i < splatter->num_threads; i++) {
+		if (splatter->workers[i].max_density > splatter->max_density) {
+			splatter->max_density = splatter->workers[i].max_density;
+		}
+	}
+
+	run_phase(splatter, SPLAT_PHASE_TONEMAP);
+
+	glBindTexture(GL_TEXTURE_2D, splatter->texture);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, splatter->width, splatter->height,
+	                GL_RED, GL_UNSIGNED_BYTE, splatter->image);
+
+	glm_mat4_copy(view_proj, splatter->last_view_proj);
+	splatter->valid = true;
+	splatter->accumulate_ns = SDL_GetTicksNS() - start;
+
+	return true;
+}
+
+void DrawSplatter(Splatter *splatter) {
+	if (splatter->program == NULL) {
+		return;
+	}
+
+	GLint previous_program, previous_vao;
+	glGetIntegerv(GL_CURRENT_PROGRAM, &previous_program);
+	glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &previous_vao);
+
+	UseShaderProgram(splatter->program);
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, splatter->texture);
+
+	glDisable(GL_DEPTH_TEST);
+	glBindVertexArray(splatter->vao);
+	glDrawArrays(GL_TRIANGLES, 0, 3);
+	glEnable(GL_DEPTH_TEST);
+
+	glBindVertexArray(previous_vao);
+	glUseProgram(previous_program);
+}
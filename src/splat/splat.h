@@ -0,0 +1,73 @@
+#ifndef SPLAT_H
+#define SPLAT_H
+
+#include <SDL3/SDL.h>
+#include <cglm/cglm.h>
+
+#include "shaders/shader.h"
+
+// Number of chaos-game points splatted on every re-accumulation by default.
+#define SPLAT_DEFAULT_POINTS 50000000ULL
+
+typedef struct SplatWorker SplatWorker;
+
+/**
+ * CPU density renderer for the chaos-game version of the fractal.
+ *
+ * Every worker thread plays the chaos game on its own share of the points and
+ * splats them into its own full-screen histogram, so no atomics are needed.
+ * The histograms are then summed row-wise (each thread owns a band of rows),
+ * tone-mapped with a log curve and uploaded to a single-channel texture which
+ * is drawn as a full-screen triangle.
+ */
+typedef struct Splatter {
+	int width;
+	int height;
+	Uint64 num_points;
+
+	int num_threads;
+	SplatWorker *workers;
+	SDL_Semaphore *done;
+
+	Uint32 *histograms; // `num_threads` histograms of `width * height` bins
+	Uint8 *image;       // Tone-mapped density, one byte per pixel
+
+	// Shared state for the current job, written before the workers start.
+	int phase;
+	vec4 clip_vertices[5];
+	Uint32 max_density;
+
+	mat4 last_view_proj;
+	bool valid; // Whether `last_view_proj` matches the uploaded texture
+
+	Uint64 accumulate_ns; // Time spent in the last re-accumulation
+
+	unsigned int texture;
+	unsigned int vao;
+	ShaderProgram *program;
+} Splatter;
+
+/**
+ * Create a splatter for a `width` x `height` framebuffer.
+ *
+ * `num_points` chaos-game points are splatted on every re-accumulation, split
+ * evenly across one worker per logical CPU core. Returns NULL if the buffers
+ * or any worker couldn't be created.
+ */
+Splatter *CreateSplatter(int width, int height, Uint64 num_points);
+
+// Stop the worker threads and free the splatter and its GL objects.
+void DestroySplatter(Splatter *splatter);
+
+/**
+ * Re-accumulate the density image for `view_proj` (perspective * view).
+ *
+ * Nothing is done if the matrix is unchanged since the last call, so this is
+ * cheap to call every frame. Returns true if the image was rebuilt.
+ */
+bool UpdateSplatter(Splatter *splatter, mat4 view_proj);
+
+// Draw the last accumulated density image over the whole viewport.
+void DrawSplatter(Splatter *splatter);
+
+#endif // SPLAT_H
@@ -0,0 +1,129 @@
+#include "timing/timing.h"
+
+#include <stdio.h>
+
+#define HALF_SUB_BUCKETS (TIMING_SUB_BUCKETS / 2)
+
+const char *stage_names[STAGE_COUNT] = {
+    "events", "input",     "generate",    "submit",     "swap",
+    "sleep",  "gpu clear", "gpu fractal", "gpu overlay"};
+
+StageHistogram stage_histograms[STAGE_COUNT];
+
+// Bucket counting `ns`, clamped to the largest value tracked.
+static int bucket_index(Uint64 ns) {
+	if (ns < TIMING_SUB_BUCKETS) {
+		return (int)ns;
+	}
+	if (ns >> TIMING_MAX_BITS) {
+		ns = ((Uint64)1 << TIMING_MAX_BITS) - 1;
+	}
+
+	int msb = TIMING_SUB_BUCKET_BITS;
+	while (ns >> (msb + 1)) {
+		msb++;
+	}
+	int shift = msb - (TIMING_SUB_BUCKET_BITS - 1);
+	return TIMING_SUB_BUCKETS + (msb - TIMING_SUB_BUCKET_BITS) * HALF_SUB_BUCKETS +
+	       (int)(ns >> shift) - HALF_SUB_BUCKETS;
+}
+
+// Largest value counted by bucket `index`.
+static Uint64 bucket_highest(int index) {
+	if (index < TIMING_SUB_BUCKETS) {
+		return (Uint64)index;
+	}
+	int offset = index - TIMING_SUB_BUCKETS;
+	int shift = offset / HALF_SUB_BUCKETS + 1;
+	Uint64 low = (Uint64)(HALF_SUB_BUCKETS + offset % HALF_SUB_BUCKETS)
+	             << shift;
+	return low + ((Uint64)1 << shift) - 1;
+}
+
+void RecordStage(Stage stage, Uint64 ns) {
+	SDL_AddAtomicInt(&stage_histograms[stage].counts[bucket_index(ns)], 1);
+}
+
+Uint64 StageCount(Stage stage) {
+	Uint64 count = 0;
+	for (int i = 0; i < TIMING_BUCKETS; i++) {
+		count += (Uint32)SDL_GetAtomicInt(&stage_histograms[stage].counts[i]);
+	}
+	return count;
+}
+
+Uint64 StagePercentile(Stage stage, double percentile) {
+	Uint64 total = StageCount(stage);
+	if (total == 0) {
+		return 0;
+	}
+
+	Uint64 target = (Uint64)(percentile / 100.0 * (double)total + 0.999999);
+	if (target < 1) {
+		target = 1;
+	}
+
+	Uint64 seen = 0;
+	int last = 0;
+	for (int i = 0; i < TIMING_BUCKETS; i++) {
+		Uint64 count =
+		    (Uint32)SDL_GetAtomicInt(&stage_histograms[stage].counts[i]);
+		if (count == 0) {
+			continue;
+		}
+		seen += count;
+		last = i;
+		if (seen >= target) {
+			return bucket_highest(i);
+		}
+	}
+	// Only if recordings came in while counting
+	return bucket_highest(last);
+}
+
+void PrintStageTimings(void) {
+#ifndef ENABLE_STAGE_TIMING
+	printf("CPU stage timing is compiled out, build with TIMING=ON\n");
+#endif
+	printf("%12s %10s %10s %10s %10s %10s\n", "stage", "frames", "p50 ms",
+	       "p95 ms", "p99 ms", "max ms");
+	for (int s = 0; s < STAGE_COUNT; s++) {
+		Stage stage = (Stage)s;
+		printf("%12s %10llu %10.3f %10.3f %10.3f %10.3f\n", stage_names[s],
+		       (unsigned long long)StageCount(stage),
+		       (double)StagePercentile(stage, 50.0) / 1e6,
+		       (double)StagePercentile(stage, 95.0) / 1e6,
+		       (double)StagePercentile(stage, 99.0) / 1e6,
+		       (double)StagePercentile(stage, 100.0) / 1e6);
+	}
+}
+
+bool WriteStageTimings(const char *path) {
+	FILE *file = fopen(path, "w");
+	if (file == NULL) {
+		perror("Could not open the stage timings file");
+		return false;
+	}
+
+	fprintf(file, "stage,count,p50_ms,p95_ms,p99_ms,max_ms\n");
+	for (int s = 0; s < STAGE_COUNT; s++) {
+		Stage stage = (Stage)s;
+		fprintf(file, "%s,%llu,%.6f,%.6f,%.6f,%.6f\n", stage_names[s],
+		        (unsigned long long)StageCount(stage),
+		        (double)StagePercentile(stage, 50.0) / 1e6,
+		        (double)StagePercentile(stage, 95.0) / 1e6,
+		        (double)StagePercentile(stage, 99.0) / 1e6,
+		        (double)StagePercentile(stage, 100.0) / 1e6);
+	}
+
+	fclose(file);
+	return true;
+}
+
+void ResetStageTimings(void) {
+	for (int s = 0; s < STAGE_COUNT; s++) {
+		for (int i = 0; i < TIMING_BUCKETS; i++) {
+			SDL_SetAtomicInt(&stage_histograms[s].counts[i], 0);
+		}
+	}
+}
@@ -0,0 +1,97 @@
+#ifndef TIMING_H
+#define TIMING_H
+
+#include <SDL3/SDL.h>
+
+#include "trace/trace.h"
+
+// Where the stage timings are written on exit and by T
+#define STAGE_TIMINGS_CSV "stage_timings.csv"
+
+// Parts of a frame that are timed, in the order they run
+typedef enum Stage {
+	STAGE_EVENTS,   // SDL_PollEvent and the key handlers
+	STAGE_INPUT,    // Keyboard, gamepad and camera update
+	STAGE_GENERATE, // Leaf generation, baking and splatting
+	STAGE_SUBMIT,   // GL calls, with the culling and recursion done while
+	                // submitting
+	STAGE_SWAP,     // SDL_GL_SwapWindow
+	STAGE_SLEEP,    // TickClock waiting for the next frame
+
+	// GPU time of the render passes, see GPUTimer in query.h. In the same
+	// order as GPUPass.
+	STAGE_GPU_CLEAR,
+	STAGE_GPU_FRACTAL,
+	STAGE_GPU_OVERLAY,
+	STAGE_COUNT
+} Stage;
+
+extern const char *stage_names[STAGE_COUNT];
+
+/**
+ * Histograms keep 2 significant digits: values below 128 ns are counted
+ * exactly, and every power of two above is split into 64 buckets, up to
+ * 2^36 ns (about a minute), like HdrHistogram.
+ */
+#define TIMING_SUB_BUCKET_BITS 7
+#define TIMING_SUB_BUCKETS (1 << TIMING_SUB_BUCKET_BITS)
+#define TIMING_MAX_BITS 36
+#define TIMING_BUCKETS                                                         \
+	(TIMING_SUB_BUCKETS +                                                      \
+	 (TIMING_MAX_BITS - TIMING_SUB_BUCKET_BITS) * TIMING_SUB_BUCKETS / 2)
+
+/**
+ * Durations recorded for one stage. Recording is a single atomic add, so
+ * any thread can record without locks.
+ */
+typedef struct StageHistogram {
+	SDL_AtomicInt counts[TIMING_BUCKETS];
+} StageHistogram;
+
+extern StageHistogram stage_histograms[STAGE_COUNT];
+
+// Count a duration of `ns` for `stage`.
+void RecordStage(Stage stage, Uint64 ns);
+
+/**
+ * The duration `percentile` (0-100) percent of the recordings of `stage` are
+ * at or below, rounded up to the end of its bucket. 0 if nothing was
+ * recorded.
+ */
+Uint64 StagePercentile(Stage stage, double percentile);
+
+// Number of durations recorded for `stage`.
+Uint64 StageCount(Stage stage);
+
+// Print p50/p95/p99/max of every stage, in milliseconds.
+void PrintStageTimings(void);
+
+/**
+ * Write one row per stage with its count and p50/p95/p99/max in
+ * milliseconds to the CSV file at `path`. Returns false if it couldn't be
+ * written.
+ */
+bool WriteStageTimings(const char *path);
+
+// Forget everything recorded so far.
+void ResetStageTimings(void);
+
+/**
+ * Time from STAGE_BEGIN to the STAGE_END of the same stage, in the same
+ * scope. The stage is also a span in trace captures (see trace.h). Both
+ * compile to nothing unless ENABLE_STAGE_TIMING is defined (the Makefile's
+ * TIMING=ON, the default).
+ */
+#ifdef ENABLE_STAGE_TIMING
+#define STAGE_BEGIN(stage)                                                     \
+	TraceBegin(stage_names[stage]);                                            \
+	Uint64 stage_start_##stage = SDL_GetTicksNS()
+#define STAGE_END(stage)                                                       \
+	RecordStage((stage), SDL_GetTicksNS() - stage_start_##stage);              \
+	TraceEnd(stage_names[stage])
+#else
+#define STAGE_BEGIN(stage)
+#define STAGE_END(stage)
+#endif
+
+#endif // TIMING_H
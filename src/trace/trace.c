@@ -0,0 +1,161 @@
+#include "trace/trace.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "memory/memory.h"
+
+Tracer tracer;
+
+// Claimed by threads past TRACE_MAX_THREADS, never records
+static TraceBuffer overflow_buffer;
+
+// The calling thread's buffer, claimed on first use.
+static TraceBuffer *thread_buffer(void) {
+	TraceBuffer *buffer = (TraceBuffer *)SDL_GetTLS(&tracer.buffer_key);
+	if (buffer != NULL) {
+		return buffer;
+	}
+
+	int index = SDL_AddAtomicInt(&tracer.thread_count, 1);
+	if (index >= TRACE_MAX_THREADS) {
+		buffer = &overflow_buffer;
+	} else {
+		buffer = &tracer.buffers[index];
+		buffer->index = index;
+		snprintf(buffer->thread_name, TRACE_THREAD_NAME_SIZE, "thread %d",
+		         index);
+	}
+	SDL_SetTLS(&tracer.buffer_key, buffer, NULL);
+	return buffer;
+}
+
+static void record(char phase, const char *name, double value) {
+	if (!IsTracing()) {
+		return;
+	}
+
+	TraceBuffer *buffer = thread_buffer();
+	if (buffer == &overflow_buffer) {
+		return;
+	}
+	if (buffer->events == NULL) {
+		buffer->events = (TraceEvent *)TaggedMalloc(
+		    MEMORY_PROFILING, sizeof(TraceEvent) * TRACE_EVENTS_PER_THREAD);
+		if (buffer->events == NULL) {
+			perror("Could not allocate memory for trace events");
+			return;
+		}
+	}
+
+	TraceEvent *event =
+	    &buffer->events[buffer->written % TRACE_EVENTS_PER_THREAD];
+	event->name = name;
+	event->ns = SDL_GetTicksNS();
+	event->value = value;
+	event->phase = phase;
+	buffer->written++;
+}
+
+void TraceThreadName(const char *name) {
+	TraceBuffer *buffer = thread_buffer();
+	if (buffer != &overflow_buffer) {
+		snprintf(buffer->thread_name, TRACE_THREAD_NAME_SIZE, "%s", name);
+	}
+}
+
+void TraceBegin(const char *name) { record('B', name, 0.0); }
+
+void TraceEnd(const char *name) { record('E', name, 0.0); }
+
+void TraceCounter(const char *name, double value) {
+	record('C', name, value);
+}
+
+void StartTrace(void) {
+	// Nothing records until `capturing` is set, so the rings can be emptied
+	// from this thread.
+	int threads = SDL_GetAtomicInt(&tracer.thread_count);
+	for (int i = 0; i < threads && i < TRACE_MAX_THREADS; i++) {
+		tracer.buffers[i].written = 0;
+	}
+	tracer.start_ns = SDL_GetTicksNS();
+	SDL_SetAtomicInt(&tracer.capturing, 1);
+}
+
+void StopTrace(void) { SDL_SetAtomicInt(&tracer.capturing, 0); }
+
+// Write the events of one thread, keeping spans balanced.
+static void write_thread(FILE *file, const TraceBuffer *buffer,
+                         bool *first) {
+	fprintf(file, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,"
+	              "\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+	        *first ? "" : ",", buffer->index, buffer->thread_name);
+	*first = false;
+
+	if (buffer->events == NULL) {
+		return;
+	}
+
+	Uint64 begin = 0;
+	if (buffer->written > TRACE_EVENTS_PER_THREAD) {
+		begin = buffer->written - TRACE_EVENTS_PER_THREAD;
+	}
+
+	int depth = 0;
+	for (Uint64 i = begin; i < buffer->written; i++) {
+		const TraceEvent *event =
+		    &buffer->events[i % TRACE_EVENTS_PER_THREAD];
+		double us = (double)(Sint64)(event->ns - tracer.start_ns) / 1e3;
+
+		if (event->phase == 'E') {
+			if (depth == 0) {
+				continue; // Its begin was overwritten
+			}
+			depth--;
+		} else if (event->phase == 'B') {
+			depth++;
+		}
+
+		fprintf(file,
+		        ",\n{\"name\":\"%s\",\"ph\":\"%c\",\"pid\":1,\"tid\":%d,"
+		        "\"ts\":%.3f",
+		        event->name, event->phase, buffer->index, us);
+		if (event->phase == 'C') {
+			fprintf(file, ",\"args\":{\"value\":%.17g}", event->value);
+		}
+		fputc('}', file);
+	}
+}
+
+bool WriteTrace(const char *path) {
+	StopTrace();
+
+	FILE *file = fopen(path, "w");
+	if (file == NULL) {
+		perror("Could not open the trace file");
+		return false;
+	}
+
+	fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+	bool first = true;
+	int threads = SDL_GetAtomicInt(&tracer.thread_count);
+	for (int i = 0; i < threads && i < TRACE_MAX_THREADS; i++) {
+		write_thread(file, &tracer.buffers[i], &first);
+	}
+	fprintf(file, "\n]}\n");
+
+	fclose(file);
+	return true;
+}
+
+void DestroyTrace(void) {
+	StopTrace();
+
+	int threads = SDL_GetAtomicInt(&tracer.thread_count);
+	for (int i = 0; i < threads && i < TRACE_MAX_THREADS; i++) {
+		TaggedFree(tracer.buffers[i].events);
+		tracer.buffers[i].events = NULL;
+		tracer.buffers[i].written = 0;
+	}
+}
@@ -0,0 +1,96 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <SDL3/SDL.h>
+
+// Where R and exiting write a capture
+#define TRACE_FILE "trace.json"
+
+// Threads that can record, later ones are ignored
+#define TRACE_MAX_THREADS 64
+
+// Events kept per thread, older ones are overwritten (32 bytes each)
+#define TRACE_EVENTS_PER_THREAD (1 << 16)
+
+// Longest thread name kept
+#define TRACE_THREAD_NAME_SIZE 32
+
+/**
+ * One event in the Chrome trace format's terms: the start ('B') or end
+ * ('E') of a span, or a counter sample ('C').
+ */
+typedef struct TraceEvent {
+	const char *name; // Not copied, must be a string literal
+	Uint64 ns;        // SDL_GetTicksNS
+	double value;     // Counters only
+	char phase;
+} TraceEvent;
+
+/**
+ * Events of one thread, only ever written by that thread. The ring is
+ * allocated the first time the thread records during a capture.
+ */
+typedef struct TraceBuffer {
+	char thread_name[TRACE_THREAD_NAME_SIZE];
+	int index; // Used as the thread ID in the export
+	TraceEvent *events;
+	Uint64 written; // Events recorded this capture, including overwritten
+} TraceBuffer;
+
+/**
+ * Timeline capture of every thread, exported as Chrome trace JSON, which
+ * Perfetto (ui.perfetto.dev) and chrome://tracing open offline.
+ *
+ * While nothing is being captured, recording is a single atomic load. While
+ * capturing it is a thread-local lookup, a clock read and a store into the
+ * thread's own ring, without locks.
+ */
+typedef struct Tracer {
+	SDL_AtomicInt capturing;
+	SDL_AtomicInt thread_count;
+	SDL_TLSID buffer_key;
+	Uint64 start_ns;
+	TraceBuffer buffers[TRACE_MAX_THREADS];
+} Tracer;
+
+extern Tracer tracer;
+
+/**
+ * Name the calling thread in the export, e.g. "main" or "splat 3". Call it
+ * when the thread starts, tracing doesn't need to be on.
+ */
+void TraceThreadName(const char *name);
+
+// Start a span named `name` on the calling thread.
+void TraceBegin(const char *name);
+
+// End the innermost open span of the calling thread.
+void TraceEnd(const char *name);
+
+// Record a sample of the counter `name`.
+void TraceCounter(const char *name, double value);
+
+// Forget earlier events and start capturing.
+void StartTrace(void);
+
+// Stop capturing. The events are kept until the next StartTrace.
+void StopTrace(void);
+
+static inline bool IsTracing(void) {
+	return SDL_GetAtomicInt(&tracer.capturing) != 0;
+}
+
+/**
+ * Stop capturing and write every thread's events, oldest first, to `path`
+ * as Chrome trace JSON. Ends whose begin was overwritten are dropped.
+ * Returns false if the file couldn't be written.
+ */
+bool WriteTrace(const char *path);
+
+/**
+ * Stop capturing and free every thread's ring. Call it at exit, once the
+ * threads that record have been joined.
+ */
+void DestroyTrace(void);
+
+#endif // TRACE_H
@@ -0,0 +1,230 @@
+#include "vcache/vcache.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "memory/memory.h"
+
+// Pick the vertex to fan around next, or -1 when every triangle is out.
+static Sint64 next_vertex(const Uint32 *candidates, Uint64 candidate_count,
+                          const Uint32 *live, const Uint64 *cache_time,
+                          Uint64 time, int cache_size, Uint32 *dead_ends,
+                          Uint64 *dead_end_count, Uint32 *cursor,
+                          Uint32 vertex_count) {
+	// The candidate still in the cache with the most time left in it, as
+	// long as its remaining triangles won't push it out
+	Sint64 best = -1;
+	Sint64 best_priority = -1;
+	for (Uint64 i = 0; i < candidate_count; i++) {
+		Uint32 v = candidates[i];
+		if (live[v] == 0) {
+			continue;
+		}
+		Sint64 priority = 0;
+		if (time - cache_time[v] + 2 * live[v] <= (Uint64)cache_size) {
+			priority = (Sint64)(time - cache_time[v]);
+		}
+		if (priority > best_priority) {
+			best_priority = priority;
+			best = v;
+		}
+	}
+	if (best >= 0) {
+		return best;
+	}
+
+	// Dead end: go back to a recently used vertex, then to the first vertex
+	// left in index order
+	while (*dead_end_count > 0) {
+		Uint32 v = dead_ends[--(*dead_end_count)];
+		if (live[v] > 0) {
+			return v;
+		}
+	}
+	while (*cursor < vertex_count) {
+		Uint32 v = (*cursor)++;
+		if (live[v] > 0) {
+			return v;
+		}
+	}
+	return -1;
+}
+
+bool OptimizeVertexCache(Uint32 *indices, Uint64 index_count,
+                         Uint32 vertex_count, int cache_size) {
+	Uint64 triangle_count = index_count / 3;
+	if (triangle_count == 0) {
+		return true;
+	}
+
+	// Triangles using each vertex, as offsets into one array
+	Uint64 *offsets = (Uint64 *)TaggedCalloc(
+	    MEMORY_MESHES, (size_t)vertex_count + 1, sizeof(Uint64));
+	Uint32 *adjacency =
+	    (Uint32 *)TaggedMalloc(MEMORY_MESHES, sizeof(Uint32) * index_count);
+	Uint32 *live =
+	    (Uint32 *)TaggedCalloc(MEMORY_MESHES, vertex_count, sizeof(Uint32));
+	Uint64 *cache_time =
+	    (Uint64 *)TaggedCalloc(MEMORY_MESHES, vertex_count, sizeof(Uint64));
+	bool *emitted =
+	    (bool *)TaggedCalloc(MEMORY_MESHES, triangle_count, sizeof(bool));
+	Uint32 *dead_ends =
+	    (Uint32 *)TaggedMalloc(MEMORY_MESHES, sizeof(Uint32) * index_count);
+	Uint32 *candidates =
+	    (Uint32 *)TaggedMalloc(MEMORY_MESHES, sizeof(Uint32) * index_count);
+	Uint32 *output =
+	    (Uint32 *)TaggedMalloc(MEMORY_MESHES, sizeof(Uint32) * index_count);
+	if (offsets == NULL || adjacency == NULL || live == NULL ||
+	    cache_time == NULL || emitted == NULL || dead_ends == NULL ||
+	    candidates == NULL || output == NULL) {
+		perror("Could not allocate memory to optimize the vertex cache");
+		TaggedFree(offsets);
+		TaggedFree(adjacency);
+		TaggedFree(live);
+		TaggedFree(cache_time);
+		TaggedFree(emitted);
+		TaggedFree(dead_ends);
+		TaggedFree(candidates);
+		TaggedFree(output);
+		return false;
+	}
+
+	for (Uint64 i = 0; i < triangle_count * 3; i++) {
+		live[indices[i]]++;
+	}
+	for (Uint32 v = 0; v < vertex_count; v++) {
+		offsets[v + 1] = offsets[v] + live[v];
+	}
+	// Fill with `cache_time` as a cursor per vertex, it's reset below
+	for (Uint64 t = 0; t < triangle_count; t++) {
+		for (int c = 0; c < 3; c++) {
+			Uint32 v = indices[t * 3 + c];
+			adjacency[offsets[v] + cache_time[v]++] = (Uint32)t;
+		}
+	}
+	memset(cache_time, 0, sizeof(Uint64) * vertex_count);
+
+	Uint64 time = (Uint64)cache_size + 1;
+	Uint64 dead_end_count = 0;
+	Uint32 cursor = 0;
+	Uint64 out = 0;
+
+	Sint64 fan = next_vertex(NULL, 0, live, cache_time, time, cache_size,
+	                         dead_ends, &dead_end_count, &cursor,
+	                         vertex_count);
+	while (fan >= 0) {
+		Uint64 candidate_count = 0;
+		for (Uint64 a = offsets[fan]; a < offsets[fan + 1]; a++) {
+			Uint32 t = adjacency[a];
+			if (emitted[t]) {
+				continue;
+			}
+			emitted[t] = true;
+
+			for (int c = 0; c < 3; c++) {
+				Uint32 v = indices[t * 3 + c];
+				output[out++] = v;
+				dead_ends[dead_end_count++] = v;
+				candidates[candidate_count++] = v;
+				live[v]--;
+				if (time - cache_time[v] > (Uint64)cache_size) {
+					cache_time[v] = time++;
+				}
+			}
+		}
+
+		fan = next_vertex(candidates, candidate_count, live, cache_time,
+		                  time, cache_size, dead_ends, &dead_end_count,
+		                  &cursor, vertex_count);
+	}
+
+	memcpy(indices, output, sizeof(Uint32) * out);
+
+	TaggedFree(offsets);
+	TaggedFree(adjacency);
+	TaggedFree(live);
+	TaggedFree(cache_time);
+	TaggedFree(emitted);
+	TaggedFree(dead_ends);
+	TaggedFree(candidates);
+	TaggedFree(output);
+	return true;
+}
+
+bool OptimizeVertexFetch(Uint32 *indices, Uint64 index_count,
+                         PackedVertex *vertices, Uint32 vertex_count) {
+	Uint32 *remap =
+	    (Uint32 *)TaggedMalloc(MEMORY_MESHES, sizeof(Uint32) * vertex_count);
+	PackedVertex *reordered = (PackedVertex *)TaggedMalloc(
+	    MEMORY_MESHES, sizeof(PackedVertex) * vertex_count);
+	if (remap == NULL || reordered == NULL) {
+		perror("Could not allocate memory to optimize vertex fetch");
+		TaggedFree(remap);
+		TaggedFree(reordered);
+		return false;
+	}
+
+	memset(remap, 0xff, sizeof(Uint32) * vertex_count);
+	Uint32 next = 0;
+	for (Uint64 i = 0; i < index_count; i++) {
+		Uint32 v = indices[i];
+		if (remap[v] == 0xffffffffu) {
+			remap[v] = next;
+			reordered[next++] = vertices[v];
+		}
+		indices[i] = remap[v];
+	}
+
+	// Unused vertices go at the end, in their old order
+	for (Uint32 v = 0; v < vertex_count; v++) {
+		if (remap[v] == 0xffffffffu) {
+			reordered[next++] = vertices[v];
+		}
+	}
+
+	memcpy(vertices, reordered, sizeof(PackedVertex) * vertex_count);
+	TaggedFree(remap);
+	TaggedFree(reordered);
+	return true;
+}
+
+VertexCacheStats SimulateVertexCache(const Uint32 *indices, Uint64 index_count,
+                                     Uint32 vertex_count, int cache_size) {
+	VertexCacheStats stats = {0, 0.0, 0.0};
+
+	// The miss count at which each vertex entered the cache, 0 if never. A
+	// vertex is evicted after `cache_size` more misses.
+	Uint64 *entered =
+	    (Uint64 *)TaggedCalloc(MEMORY_MESHES, vertex_count, sizeof(Uint64));
+	if (entered == NULL) {
+		perror("Could not allocate memory to simulate the vertex cache");
+		return stats;
+	}
+
+	for (Uint64 i = 0; i < index_count; i++) {
+		Uint32 v = indices[i];
+		if (entered[v] == 0 || stats.misses - entered[v] >= (Uint64)cache_size) {
+			stats.misses++;
+			entered[v] = stats.misses;
+		}
+	}
+	TaggedFree(entered);
+
+	if (index_count >= 3) {
+		stats.acmr = (double)stats.misses / (double)(index_count / 3);
+	}
+	if (vertex_count > 0) {
+		stats.atvr = (double)stats.misses / (double)vertex_count;
+	}
+	return stats;
+}
+
+int VertexCacheSize(void) {
+	const char *value = SDL_getenv("SIERPINSKI_VCACHE_SIZE");
+	if (value == NULL) {
+		return VCACHE_DEFAULT_SIZE;
+	}
+	int size = atoi(value);
+	return size >= 1 && size <= VCACHE_MAX_SIZE ? size : VCACHE_DEFAULT_SIZE;
+}
@@ -0,0 +1,62 @@
+#ifndef VCACHE_H
+#define VCACHE_H
+
+#include <SDL3/SDL.h>
+
+#include "mesh/mesh.h"
+
+// Post-transform cache size, in vertices, the index order is optimized for
+// unless SIERPINSKI_VCACHE_SIZE says otherwise.
+#define VCACHE_DEFAULT_SIZE 16
+
+// Largest cache size accepted from the environment.
+#define VCACHE_MAX_SIZE 64
+
+// Result of running an index buffer through a simulated vertex cache
+typedef struct VertexCacheStats {
+	Uint64 misses; // Vertices transformed
+	double acmr;   // Average cache miss ratio, misses per triangle (0.5-3)
+	double atvr;   // Average transform to vertex ratio, misses per vertex
+	               // (1 is ideal)
+} VertexCacheStats;
+
+/**
+ * Reorder the triangles of an indexed triangle list for a post-transform
+ * vertex cache of `cache_size` entries, in place.
+ *
+ * This is Tipsify (Sander, Nehab and Barczak, "Fast Triangle Reordering for
+ * Vertex Locality and Reduced Overdraw", 2007): triangles are emitted as fans
+ * around a vertex, and the next fan is the one around the recently used
+ * vertex most likely to still be cached. It is linear in the index count and
+ * has no randomness or hashing, so the same input always gives the same
+ * order.
+ *
+ * Returns false (leaving `indices` as they were) if out of memory.
+ */
+bool OptimizeVertexCache(Uint32 *indices, Uint64 index_count,
+                         Uint32 vertex_count, int cache_size);
+
+/**
+ * Renumber `vertices` in the order `indices` first uses them, so vertex
+ * fetches walk the buffer forwards. `indices` are rewritten to match.
+ *
+ * Returns false (leaving both as they were) if out of memory.
+ */
+bool OptimizeVertexFetch(Uint32 *indices, Uint64 index_count,
+                         PackedVertex *vertices, Uint32 vertex_count);
+
+/**
+ * Run an indexed triangle list through a FIFO post-transform cache of
+ * `cache_size` entries, the model most GPUs are closest to, and count the
+ * vertices transformed.
+ */
+VertexCacheStats SimulateVertexCache(const Uint32 *indices, Uint64 index_count,
+                                     Uint32 vertex_count, int cache_size);
+
+/**
+ * The cache size to optimize for, from SIERPINSKI_VCACHE_SIZE if it is set to
+ * a size from 1 to VCACHE_MAX_SIZE.
+ */
+int VertexCacheSize(void);
+
+#endif // VCACHE_H
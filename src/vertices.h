@@ -1,7 +1,7 @@
 #ifndef VERTICES_H
 #define VERTICES_H
 
-float triangle[] = {
+static const float triangle[] = {
     // Coords           // Colors
     0.0,  0.5,  0.0,  0.0, 0.0, 1.0, //  top
     0.5,  -0.5, -0.5, 0.0, 0.0, 1.0, //  right_back
@@ -28,4 +28,72 @@ float triangle[] = {
     0.5,  -0.5, 0.5,  0.0, 1.0, 1.0, //  right_front
 };
 
+// Unit cube centered at the origin, the base of the cube-based IFSs (see
+// ifs.h). Opposite faces share a color.
+static const float cube[] = {
+    // Coords            // Colors
+    0.5,  -0.5, -0.5, 1.0, 0.0, 0.0, //  +x
+    0.5,  0.5,  -0.5, 1.0, 0.0, 0.0,
+    0.5,  0.5,  0.5,  1.0, 0.0, 0.0,
+    0.5,  -0.5, -0.5, 1.0, 0.0, 0.0,
+    0.5,  0.5,  0.5,  1.0, 0.0, 0.0,
+    0.5,  -0.5, 0.5,  1.0, 0.0, 0.0,
+
+    -0.5, -0.5, -0.5, 1.0, 0.0, 0.0, //  -x
+    -0.5, -0.5, 0.5,  1.0, 0.0, 0.0,
+    -0.5, 0.5,  0.5,  1.0, 0.0, 0.0,
+    -0.5, -0.5, -0.5, 1.0, 0.0, 0.0,
+    -0.5, 0.5,  0.5,  1.0, 0.0, 0.0,
+    -0.5, 0.5,  -0.5, 1.0, 0.0, 0.0,
+
+    -0.5, 0.5,  -0.5, 0.0, 1.0, 0.0, //  +y
+    -0.5, 0.5,  0.5,  0.0, 1.0, 0.0,
+    0.5,  0.5,  0.5,  0.0, 1.0, 0.0,
+    -0.5, 0.5,  -0.5, 0.0, 1.0, 0.0,
+    0.5,  0.5,  0.5,  0.0, 1.0, 0.0,
+    0.5,  0.5,  -0.5, 0.0, 1.0, 0.0,
+
+    -0.5, -0.5, -0.5, 0.0, 1.0, 0.0, //  -y
+    0.5,  -0.5, -0.5, 0.0, 1.0, 0.0,
+    0.5,  -0.5, 0.5,  0.0, 1.0, 0.0,
+    -0.5, -0.5, -0.5, 0.0, 1.0, 0.0,
+    0.5,  -0.5, 0.5,  0.0, 1.0, 0.0,
+    -0.5, -0.5, 0.5,  0.0, 1.0, 0.0,
+
+    -0.5, -0.5, 0.5,  0.0, 0.0, 1.0, //  +z
+    0.5,  -0.5, 0.5,  0.0, 0.0, 1.0,
+    0.5,  0.5,  0.5,  0.0, 0.0, 1.0,
+    -0.5, -0.5, 0.5,  0.0, 0.0, 1.0,
+    0.5,  0.5,  0.5,  0.0, 0.0, 1.0,
+    -0.5, 0.5,  0.5,  0.0, 0.0, 1.0,
+
+    -0.5, -0.5, -0.5, 0.0, 0.0, 1.0, //  -z
+    -0.5, 0.5,  -0.5, 0.0, 0.0, 1.0,
+    0.5,  0.5,  -0.5, 0.0, 0.0, 1.0,
+    -0.5, -0.5, -0.5, 0.0, 0.0, 1.0,
+    0.5,  0.5,  -0.5, 0.0, 0.0, 1.0,
+    0.5,  -0.5, -0.5, 0.0, 0.0, 1.0,
+};
+
+// Regular tetrahedron on alternate corners of the unit cube, the base of the
+// Sierpinski tetrahedron.
+static const float tetrahedron[] = {
+    // Coords            // Colors
+    0.5,  0.5,  0.5,  0.0, 0.0, 1.0,
+    0.5,  -0.5, -0.5, 0.0, 0.0, 1.0,
+    -0.5, 0.5,  -0.5, 0.0, 0.0, 1.0,
+
+    0.5,  0.5,  0.5,  1.0, 1.0, 0.0,
+    -0.5, -0.5, 0.5,  1.0, 1.0, 0.0,
+    0.5,  -0.5, -0.5, 1.0, 1.0, 0.0,
+
+    0.5,  0.5,  0.5,  0.0, 1.0, 0.0,
+    -0.5, 0.5,  -0.5, 0.0, 1.0, 0.0,
+    -0.5, -0.5, 0.5,  0.0, 1.0, 0.0,
+
+    0.5,  -0.5, -0.5, 1.0, 0.0, 0.0,
+    -0.5, -0.5, 0.5,  1.0, 0.0, 0.0,
+    -0.5, 0.5,  -0.5, 1.0, 0.0, 0.0,
+};
+
 #endif // VERTICES_H
\ No newline at end of file
@@ -0,0 +1,60 @@
+/**
+ * Build-time generator for the leaf tables of the shallow pyramids.
+ *
+ * Prints a header with every leaf of the pyramid at depths 0 to
+ * BAKED_LEAF_MAX_DEPTH, in traversal order, as hex float literals so the
+ * values are exact. The Makefile runs it into the objects folder and
+ * CreateIFSLeafBuffer hands out these tables instead of generating them.
+ *
+ * It recurses like draw_serpinskis_triangle rather than reusing the runtime
+ * generator, so VerifyBakedLeaves actually compares two implementations.
+ */
+#include <stdio.h>
+
+#define BAKED_LEAF_MAX_DEPTH 5
+
+// Same as leaf_child_offsets in leaves.c
+static const float offsets[5][3] = {
+    {0.0f, 0.5f, 0.0f},    // top
+    {-0.5f, -0.5f, 0.5f},  // left_front
+    {-0.5f, -0.5f, -0.5f}, // left_back
+    {0.5f, -0.5f, 0.5f},   // right_front
+    {0.5f, -0.5f, -0.5f},  // right_back
+};
+
+static void print_leaves(const float center[3], float scale, int depth) {
+	if (depth == 0) {
+		printf("    {{%af, %af, %af}, %af},\n", center[0], center[1],
+		       center[2], scale);
+		return;
+	}
+
+	float child_scale = scale * 0.5f;
+	for (int c = 0; c < 5; c++) {
+		float child[3] = {center[0] + offsets[c][0] * child_scale,
+		                  center[1] + offsets[c][1] * child_scale,
+		                  center[2] + offsets[c][2] * child_scale};
+		print_leaves(child, child_scale, depth - 1);
+	}
+}
+
+int main(void) {
+	printf("// Generated by tools/bake_leaves.c, do not edit.\n");
+	printf("#ifndef BAKED_LEAVES_H\n#define BAKED_LEAVES_H\n\n");
+	printf("#include \"leaves/leaves.h\"\n\n");
+	printf("#define BAKED_LEAF_MAX_DEPTH %d\n\n", BAKED_LEAF_MAX_DEPTH);
+
+	const float root[3] = {0.0f, 0.0f, 0.0f};
+	for (int depth = 0; depth <= BAKED_LEAF_MAX_DEPTH; depth++) {
+		printf("static const Leaf baked_leaves_%d[] = {\n", depth);
+		print_leaves(root, 1.0f, depth);
+		printf("};\n\n");
+	}
+
+	printf("static const Leaf *const baked_leaves[] = {\n");
+	for (int depth = 0; depth <= BAKED_LEAF_MAX_DEPTH; depth++) {
+		printf("    baked_leaves_%d,\n", depth);
+	}
+	printf("};\n\n#endif // BAKED_LEAVES_H\n");
+	return 0;
+}
@@ -0,0 +1,359 @@
+/**
+ * Performance regression gate, run by `make perfcheck`.
+ *
+ *     perfcheck [--tolerance T] BASELINE RUN.json...
+ *     perfcheck --record BASELINE RUN.json...
+ *
+ * The runs are results of the benchmark suite (bench/bench.c), repeated so
+ * every metric has a median and a median absolute deviation (MAD) across
+ * runs. --record writes them as the new baseline. Otherwise each metric in
+ * the baseline is compared, and it regressed if its median got slower by
+ * more than PERFCHECK_SIGMAS standard deviations (estimated from both MADs)
+ * and by more than the relative tolerance (PERFCHECK_TOLERANCE by default).
+ * Both have to hold, so noisy metrics need a real difference and stable ones
+ * don't fail on a change too small to matter. Exits with 1 if any did.
+ *
+ * Metrics missing from the runs (e.g. the GL ones without a context) are
+ * skipped, and new ones are listed as untracked. Every metric is lower is
+ * better. If the CPU, compiler or build differs from the baseline's nothing
+ * is compared and it exits with 2, like for usage and read errors.
+ *
+ * Only the format bench.out writes is read: one metric per line, and the
+ * machine fields one per line.
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PERFCHECK_MAX_METRICS 256
+#define PERFCHECK_MAX_RUNS 64
+#define PERFCHECK_MAX_MACHINE_LINES 32
+#define PERFCHECK_NAME_SIZE 96
+#define PERFCHECK_LINE_SIZE 1024
+
+// Machine fields that must match the baseline's, timings from another CPU,
+// compiler or build aren't comparable
+static const char *required_fields[] = {"\"cpu\":", "\"compiler\":",
+                                        "\"build\":"};
+
+#define PERFCHECK_SIGMAS 3.0
+#define PERFCHECK_TOLERANCE 0.10
+
+// Scales a MAD to the standard deviation of normally distributed samples
+#define MAD_TO_SIGMA 1.4826
+
+typedef struct Metric {
+	char name[PERFCHECK_NAME_SIZE];
+	char unit[16];
+	double values[PERFCHECK_MAX_RUNS];
+	int count;
+	double median;
+	double mad;
+} Metric;
+
+typedef struct Results {
+	Metric metrics[PERFCHECK_MAX_METRICS];
+	int count;
+	char machine[PERFCHECK_MAX_MACHINE_LINES][PERFCHECK_LINE_SIZE];
+	int machine_lines;
+	int runs;
+} Results;
+
+static int compare_doubles(const void *a, const void *b) {
+	double x = *(const double *)a;
+	double y = *(const double *)b;
+	return (x > y) - (x < y);
+}
+
+static double median(double *values, int count) {
+	qsort(values, count, sizeof(double), compare_doubles);
+	if (count % 2 == 1) {
+		return values[count / 2];
+	}
+	return (values[count / 2 - 1] + values[count / 2]) / 2.0;
+}
+
+// Copy the string after `key` in `line` into `out`. Returns 0 if missing.
+static int read_string(const char *line, const char *key, char *out,
+                       size_t size) {
+	const char *start = strstr(line, key);
+	if (start == NULL) {
+		return 0;
+	}
+	start += strlen(key);
+	const char *end = strchr(start, '"');
+	if (end == NULL) {
+		return 0;
+	}
+	size_t length = (size_t)(end - start);
+	if (length >= size) {
+		length = size - 1;
+	}
+	memcpy(out, start, length);
+	out[length] = '\0';
+	return 1;
+}
+
+// Read the number after `key` in `line` into `out`. Returns 0 if missing.
+static int read_number(const char *line, const char *key, double *out) {
+	const char *start = strstr(line, key);
+	if (start == NULL) {
+		return 0;
+	}
+	*out = strtod(start + strlen(key), NULL);
+	return 1;
+}
+
+static Metric *find_metric(Results *results, const char *name) {
+	for (int i = 0; i < results->count; i++) {
+		if (strcmp(results->metrics[i].name, name) == 0) {
+			return &results->metrics[i];
+		}
+	}
+	return NULL;
+}
+
+/**
+ * Add the metrics of the file at `path` to `results`, reading `value_key`
+ * ("value" for runs, "median" for the baseline). The machine fields are
+ * kept from the first file. Returns 0 if it couldn't be read.
+ */
+static int read_results(Results *results, const char *path,
+                        const char *value_key) {
+	FILE *file = fopen(path, "r");
+	if (file == NULL) {
+		perror(path);
+		return 0;
+	}
+
+	char key[32];
+	snprintf(key, sizeof(key), "\"%s\": ", value_key);
+	int in_machine = 0;
+	int first = results->runs == 0;
+	char line[PERFCHECK_LINE_SIZE];
+	while (fgets(line, sizeof(line), file) != NULL) {
+		if (strstr(line, "\"machine\": {") != NULL) {
+			in_machine = 1;
+			continue;
+		}
+		if (in_machine) {
+			if (strchr(line, '}') != NULL) {
+				in_machine = 0;
+			} else if (first &&
+			           results->machine_lines < PERFCHECK_MAX_MACHINE_LINES) {
+				// Without the indent and separator, the last field has none
+				size_t length = strcspn(line, "\n");
+				if (length > 0 && line[length - 1] == ',') {
+					length--;
+				}
+				line[length] = '\0';
+				snprintf(results->machine[results->machine_lines++],
+				         PERFCHECK_LINE_SIZE, "%s", line + strspn(line, " "));
+			}
+			continue;
+		}
+
+		char name[PERFCHECK_NAME_SIZE];
+		double value;
+		if (!read_string(line, "\"name\": \"", name, sizeof(name)) ||
+		    !read_number(line, key, &value)) {
+			continue;
+		}
+		Metric *metric = find_metric(results, name);
+		if (metric == NULL) {
+			if (results->count == PERFCHECK_MAX_METRICS) {
+				continue;
+			}
+			metric = &results->metrics[results->count++];
+			snprintf(metric->name, sizeof(metric->name), "%s", name);
+			read_string(line, "\"unit\": \"", metric->unit,
+			            sizeof(metric->unit));
+		}
+		if (metric->count < PERFCHECK_MAX_RUNS) {
+			metric->values[metric->count++] = value;
+		}
+		// Only in the baseline
+		read_number(line, "\"mad\": ", &metric->mad);
+	}
+
+	fclose(file);
+	results->runs++;
+	return 1;
+}
+
+// Median and MAD of every metric across the runs.
+static void summarize(Results *results) {
+	for (int i = 0; i < results->count; i++) {
+		Metric *metric = &results->metrics[i];
+		double values[PERFCHECK_MAX_RUNS];
+		memcpy(values, metric->values, sizeof(double) * metric->count);
+		metric->median = median(values, metric->count);
+		for (int v = 0; v < metric->count; v++) {
+			values[v] = fabs(metric->values[v] - metric->median);
+		}
+		metric->mad = median(values, metric->count);
+	}
+}
+
+static int record(const Results *runs, const char *path) {
+	FILE *file = fopen(path, "w");
+	if (file == NULL) {
+		perror(path);
+		return 1;
+	}
+
+	fprintf(file, "{\n  \"machine\": {\n");
+	for (int i = 0; i < runs->machine_lines; i++) {
+		fprintf(file, "    %s%s\n", runs->machine[i],
+		        i + 1 < runs->machine_lines ? "," : "");
+	}
+	fprintf(file, "  },\n  \"runs\": %d,\n  \"metrics\": [\n", runs->runs);
+	for (int i = 0; i < runs->count; i++) {
+		const Metric *metric = &runs->metrics[i];
+		fprintf(file,
+		        "    {\"name\": \"%s\", \"unit\": \"%s\", \"median\": %.6g, "
+		        "\"mad\": %.6g}%s\n",
+		        metric->name, metric->unit, metric->median, metric->mad,
+		        i + 1 < runs->count ? "," : "");
+	}
+	fprintf(file, "  ]\n}\n");
+	fclose(file);
+
+	printf("Baseline of %d metrics over %d runs written to %s\n", runs->count,
+	       runs->runs, path);
+	return 0;
+}
+
+static int is_required(const char *machine_line) {
+	for (size_t i = 0; i < sizeof(required_fields) / sizeof(char *); i++) {
+		if (strncmp(machine_line, required_fields[i],
+		            strlen(required_fields[i])) == 0) {
+			return 1;
+		}
+	}
+	return 0;
+}
+
+static int check(Results *baseline, Results *runs, double tolerance) {
+	int mismatches = 0;
+	for (int i = 0; i < baseline->machine_lines; i++) {
+		int found = 0;
+		for (int j = 0; j < runs->machine_lines; j++) {
+			found |= strcmp(baseline->machine[i], runs->machine[j]) == 0;
+		}
+		if (found) {
+			continue;
+		}
+		if (is_required(baseline->machine[i])) {
+			fprintf(stderr, "Error: the baseline was recorded with %s\n",
+			        baseline->machine[i]);
+			mismatches++;
+		} else {
+			printf("Warning: the baseline was recorded with %s\n",
+			       baseline->machine[i]);
+		}
+	}
+	if (mismatches > 0) {
+		fprintf(stderr, "The timings can't be compared, record a baseline "
+		                "here with `make perfcheck-baseline`\n");
+		return 2;
+	}
+	if (runs->runs < 3) {
+		printf("Warning: %d run(s) give no spread, use at least 3\n",
+		       runs->runs);
+	}
+
+	printf("%-44s %12s %12s %8s %8s %s\n", "metric", "baseline", "median",
+	       "change", "limit", "");
+	int regressions = 0;
+	for (int i = 0; i < baseline->count; i++) {
+		const Metric *base = &baseline->metrics[i];
+		const Metric *metric = find_metric(runs, base->name);
+		if (metric == NULL) {
+			printf("%-44s %12.4g %12s %8s %8s skipped\n", base->name,
+			       base->median, "-", "-", "-");
+			continue;
+		}
+
+		double sigma = MAD_TO_SIGMA * sqrt(base->mad * base->mad +
+		                                   metric->mad * metric->mad);
+		double limit = PERFCHECK_SIGMAS * sigma;
+		if (limit < tolerance * base->median) {
+			limit = tolerance * base->median;
+		}
+		double change = metric->median - base->median;
+
+		const char *status = "";
+		if (change > limit) {
+			status = "REGRESSED";
+			regressions++;
+		} else if (-change > limit) {
+			status = "faster";
+		}
+		printf("%-44s %12.4g %12.4g %+7.1f%% %7.1f%% %s\n", base->name,
+		       base->median, metric->median,
+		       100.0 * change / base->median, 100.0 * limit / base->median,
+		       status);
+	}
+
+	for (int i = 0; i < runs->count; i++) {
+		if (find_metric(baseline, runs->metrics[i].name) == NULL) {
+			printf("%-44s %12s %12.4g %8s %8s untracked\n",
+			       runs->metrics[i].name, "-", runs->metrics[i].median, "-",
+			       "-");
+		}
+	}
+
+	if (regressions > 0) {
+		printf("%d metric(s) regressed\n", regressions);
+		return 1;
+	}
+	printf("No regressions\n");
+	return 0;
+}
+
+int main(int argc, char *argv[]) {
+	int recording = 0;
+	double tolerance = PERFCHECK_TOLERANCE;
+	int arg = 1;
+	for (; arg < argc && strncmp(argv[arg], "--", 2) == 0; arg++) {
+		if (strcmp(argv[arg], "--record") == 0) {
+			recording = 1;
+		} else if (strcmp(argv[arg], "--tolerance") == 0 && arg + 1 < argc) {
+			tolerance = strtod(argv[++arg], NULL);
+		} else {
+			fprintf(stderr, "Unknown option %s\n", argv[arg]);
+			return 2;
+		}
+	}
+	if (argc - arg < 2) {
+		fprintf(stderr,
+		        "Usage: %s [--record] [--tolerance T] BASELINE RUN.json...\n",
+		        argv[0]);
+		return 2;
+	}
+	const char *baseline_path = argv[arg++];
+
+	static Results runs, baseline;
+	for (; arg < argc; arg++) {
+		if (!read_results(&runs, argv[arg], "value")) {
+			return 2;
+		}
+	}
+	summarize(&runs);
+
+	if (recording) {
+		return record(&runs, baseline_path);
+	}
+
+	if (!read_results(&baseline, baseline_path, "median")) {
+		fprintf(stderr, "Record a baseline with `make perfcheck-baseline`\n");
+		return 2;
+	}
+	// A single value per metric, its median is itself
+	for (int i = 0; i < baseline.count; i++) {
+		baseline.metrics[i].median = baseline.metrics[i].values[0];
+	}
+	return check(&baseline, &runs, tolerance);
+}